@@ -33,36 +33,576 @@
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "ecdsa-engine.h"
-#include "ecdsa-engines\ecdsa-engine-impl.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
+#include "dev/watchdog.h"
+#include "sys/rtimer.h"
+#include "sys/clock.h"
 
+/* Bytes fed to each of the two transaction digests in turn. */
+#define TRX_DIGEST_SLICE    1024
 
+const uint8_t ecdsa_empty_cfd_hash[32] = { 0 };
+
+/* Backend registry. A backend is usable once its init() has succeeded. */
+static struct
+{
+    const ecdsa_engine_backend_t* backends[ECDSA_ENGINE_MAX_BACKENDS];
+    uint8_t usable[ECDSA_ENGINE_MAX_BACKENDS];
+    uint8_t count;
+    uint8_t builtins_registered;
+    ecdsa_curve_t curve;
+    const ecdsa_engine_backend_t* hash;
+    const ecdsa_engine_backend_t* random;
+    const ecdsa_engine_backend_t* selected[ECDSA_OP_COUNT];
+    uint32_t ticks[ECDSA_OP_COUNT];
+    /* Calibration results per backend: CALIB_RUN once it has been
+       calibrated, a bit per operation it passed, and the time each took. */
+    uint8_t calibrated[ECDSA_ENGINE_MAX_BACKENDS];
+    uint32_t calib_ticks[ECDSA_ENGINE_MAX_BACKENDS][ECDSA_OP_COUNT];
+} g_engine;
+
+#define CALIB_RUN           0x80
+
+/* Calibration vector, valid on both curves: the NIST P-256 ECDSA example
+   private key, nonce and message hash. */
+static const uint8_t calib_priv[32] = {
+    0xC4, 0x77, 0xF9, 0xF6, 0x5C, 0x22, 0xCC, 0xE2,
+    0x06, 0x57, 0xFA, 0xA5, 0xB2, 0xD1, 0xD8, 0x12,
+    0x23, 0x36, 0xF8, 0x51, 0xA5, 0x08, 0xA1, 0xED,
+    0x04, 0xE4, 0x79, 0xC3, 0x49, 0x85, 0xBF, 0x96 };
+
+static const uint8_t calib_k[32] = {
+    0x7A, 0x1A, 0x7E, 0x52, 0x79, 0x7F, 0xC8, 0xCA,
+    0xAA, 0x43, 0x5D, 0x2A, 0x4D, 0xAC, 0xE3, 0x91,
+    0x58, 0x50, 0x4B, 0xF2, 0x04, 0xFB, 0xE1, 0x9F,
+    0x14, 0xDB, 0xB4, 0x27, 0xFA, 0xEE, 0x50, 0xAE };
+
+static const uint8_t calib_hash[32] = {
+    0xA4, 0x1A, 0x41, 0xA1, 0x2A, 0x79, 0x95, 0x48,
+    0x21, 0x1C, 0x41, 0x0C, 0x65, 0xD8, 0x13, 0x3A,
+    0xFD, 0xE3, 0x4D, 0x28, 0xBD, 0xD5, 0x42, 0xE4,
+    0xB6, 0x80, 0xCF, 0x28, 0x99, 0xC8, 0xA8, 0xC4 };
+
+static int backend_ok(uint8_t i)
+{
+    return g_engine.usable[i] &&
+        (g_engine.backends[i]->caps & ECDSA_CAP_CURVE(g_engine.curve));
+}
+
+int ecdsa_engine_register(const ecdsa_engine_backend_t* backend)
+{
+    if(g_engine.count >= ECDSA_ENGINE_MAX_BACKENDS)
+    {
+        return -1;
+    }
+    g_engine.backends[g_engine.count] = backend;
+    g_engine.usable[g_engine.count] = 0;
+    g_engine.count++;
+    return 0;
+}
 
 void ecdsa_init()
 {
-    ecdsa_impl_init();
+    uint8_t i;
+
+    if(!g_engine.builtins_registered)
+    {
+        ecdsa_engine_register(&ecdsa_uecc_backend);
+#if ECDSA_ENGINE_WITH_CC26X2
+        ecdsa_engine_register(&ecdsa_cc26x2_backend);
+#endif
+        g_engine.builtins_registered = 1;
+    }
+
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        g_engine.usable[i] = (g_engine.backends[i]->init() == 0);
+    }
+
+    ecdsa_set_curve(ECDSA_ENGINE_DEFAULT_CURVE);
+    ecdsa_engine_calibrate();
 }
 
-int ecdsa_sign(
+static void select_backends();
+
+int ecdsa_set_curve(ecdsa_curve_t curve)
+{
+    uint8_t i;
+    int found = 0;
+
+    g_engine.curve = curve;
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        if(backend_ok(i) && g_engine.backends[i]->set_curve(curve) == 0)
+        {
+            found = 1;
+        }
+    }
+
+    /* The cached key belongs to the previous curve. The boot calibration
+       still ranks the backends; only those without the curve drop out. */
+    ecdsa_pubkey_cache_clear();
+    select_backends();
+    return found ? 0 : -1;
+}
+
+ecdsa_curve_t ecdsa_get_curve()
+{
+    return g_engine.curve;
+}
+
+const ecdsa_engine_backend_t* ecdsa_engine_find(uint8_t caps)
+{
+    uint8_t i;
+
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        if(backend_ok(i) && (g_engine.backends[i]->caps & caps) == caps)
+        {
+            return g_engine.backends[i];
+        }
+    }
+    return NULL;
+}
+
+const ecdsa_engine_backend_t* ecdsa_engine_selected(ecdsa_engine_op_t op)
+{
+    return g_engine.selected[op];
+}
+
+uint32_t ecdsa_engine_ticks(ecdsa_engine_op_t op)
+{
+    return g_engine.ticks[op];
+}
+
+/* Record that backend i passed calibration for op in the given time. */
+static void consider(ecdsa_engine_op_t op, uint8_t i, uint32_t ticks)
+{
+    g_engine.calibrated[i] |= (uint8_t)(1 << op);
+    g_engine.calib_ticks[i][op] = ticks;
+}
+
+/* Whether backend i implements op at all. */
+static int backend_has_op(uint8_t i, ecdsa_engine_op_t op)
+{
+    return (op != ECDSA_OP_GET_PUBKEY) || (g_engine.backends[i]->get_pubkey != NULL);
+}
+
+/* Select, for each operation, the fastest backend that passed calibration and
+   supports the current curve. A backend not calibrated yet, e.g. one lacking
+   the curve ecdsa_init() calibrated on, is taken only when no calibrated
+   backend can do the operation. */
+static void select_backends()
+{
+    uint8_t i;
+    uint8_t op;
+
+    for(op = 0; op < ECDSA_OP_COUNT; ++op)
+    {
+        g_engine.selected[op] = NULL;
+        g_engine.ticks[op] = 0;
+    }
+    g_engine.hash = NULL;
+    g_engine.random = NULL;
+
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        const ecdsa_engine_backend_t* b = g_engine.backends[i];
+
+        if(!backend_ok(i))
+        {
+            continue;
+        }
+        if(!g_engine.hash && b->hash)
+        {
+            g_engine.hash = b;
+        }
+        if(!g_engine.random && b->random)
+        {
+            g_engine.random = b;
+        }
+
+        for(op = 0; op < ECDSA_OP_COUNT; ++op)
+        {
+            if((g_engine.calibrated[i] & (1 << op)) &&
+                (!g_engine.selected[op] || g_engine.calib_ticks[i][op] < g_engine.ticks[op]))
+            {
+                g_engine.selected[op] = b;
+                g_engine.ticks[op] = g_engine.calib_ticks[i][op];
+            }
+        }
+    }
+
+    for(op = 0; op < ECDSA_OP_COUNT; ++op)
+    {
+        for(i = 0; i < g_engine.count && !g_engine.selected[op]; ++i)
+        {
+            if(backend_ok(i) && !(g_engine.calibrated[i] & CALIB_RUN) && backend_has_op(i, op))
+            {
+                g_engine.selected[op] = g_engine.backends[i];
+            }
+        }
+    }
+}
+
+void ecdsa_engine_calibrate()
+{
+    uint8_t pub[ECDSA_ENGINE_MAX_BACKENDS][64];
+    ecdsa_signature_t sig[ECDSA_ENGINE_MAX_BACKENDS];
+    uint32_t sign_ticks[ECDSA_ENGINE_MAX_BACKENDS];
+    uint8_t have_pub[ECDSA_ENGINE_MAX_BACKENDS] = { 0 };
+    uint8_t signed_ok[ECDSA_ENGINE_MAX_BACKENDS] = { 0 };
+    int ref_pub = -1;
+    uint8_t i;
+    uint8_t j;
+
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        const ecdsa_engine_backend_t* b = g_engine.backends[i];
+        rtimer_clock_t start;
+
+        if(!backend_ok(i))
+        {
+            continue;
+        }
+        g_engine.calibrated[i] = CALIB_RUN;
+
+        /* Public key derivation must agree with the first backend's. */
+        if(b->get_pubkey)
+        {
+            start = RTIMER_NOW();
+            have_pub[i] = (b->get_pubkey(calib_priv, pub[i]) == 0);
+            if(have_pub[i] && ref_pub < 0)
+            {
+                ref_pub = i;
+            }
+            if(have_pub[i] && memcmp(pub[i], pub[ref_pub], 64) == 0)
+            {
+                consider(ECDSA_OP_GET_PUBKEY, i, (uint32_t)(RTIMER_NOW() - start));
+            }
+            watchdog_periodic();
+        }
+
+        start = RTIMER_NOW();
+        signed_ok[i] = (b->sign(calib_priv, calib_k, calib_hash, sig[i].r, sig[i].s) == 0);
+        sign_ticks[i] = (uint32_t)(RTIMER_NOW() - start);
+        watchdog_periodic();
+    }
+
+    if(ref_pub < 0)
+    {
+        /* Nothing to check signatures against; take the first capable
+           backend for each operation. */
+        for(i = 0; i < g_engine.count; ++i)
+        {
+            if(backend_ok(i))
+            {
+                consider(ECDSA_OP_SIGN, i, 0);
+                consider(ECDSA_OP_VERIFY, i, 0);
+                break;
+            }
+        }
+        select_backends();
+        return;
+    }
+
+    /* Each verifier checks the signature of the next signer, so with two
+       correct backends each one's signature is verified by the other. A
+       pairing that fails cannot tell which side is wrong, so the verifier
+       moves on to the following signers, ending with its own signature. */
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        const ecdsa_engine_backend_t* b = g_engine.backends[i];
+        uint8_t n;
+
+        if(!backend_ok(i))
+        {
+            continue;
+        }
+
+        for(n = 1; n <= g_engine.count; ++n)
+        {
+            rtimer_clock_t start;
+            uint32_t ticks;
+            int ok;
+
+            j = (i + n) % g_engine.count;
+            if(!signed_ok[j])
+            {
+                continue;
+            }
+
+            start = RTIMER_NOW();
+            ok = (b->verify(pub[ref_pub], calib_hash, sig[j].r, sig[j].s) == 0);
+            ticks = (uint32_t)(RTIMER_NOW() - start);
+            watchdog_periodic();
+
+            /* The verifier must also reject the signature for another hash. */
+            if(ok)
+            {
+                uint8_t other[32];
+                memcpy(other, calib_hash, sizeof(other));
+                other[31] ^= 1;
+                ok = (b->verify(pub[ref_pub], other, sig[j].r, sig[j].s) != 0);
+                watchdog_periodic();
+            }
+
+            if(ok)
+            {
+                consider(ECDSA_OP_VERIFY, i, ticks);
+                consider(ECDSA_OP_SIGN, j, sign_ticks[j]);
+                break;
+            }
+        }
+    }
+
+    select_backends();
+}
+
+/* Public key derived from the device's private key. The key is identified by
+   its SHA-256 so that no second copy of the private key is kept. */
+static struct
+{
+    uint8_t valid;
+    uint8_t key_id[32];
+    uint8_t pub_key[64];
+} g_pubkey_cache;
+
+int ecdsa_get_pubkey(
     const uint8_t priv_key[32],
+    uint8_t pub_key[64])
+{
+    uint8_t key_id[32];
+
+    sha256(priv_key, 32, key_id);
+
+    if(!g_pubkey_cache.valid || memcmp(key_id, g_pubkey_cache.key_id, sizeof(key_id)) != 0)
+    {
+        g_pubkey_cache.valid = 0;
+        const ecdsa_engine_backend_t* b = g_engine.selected[ECDSA_OP_GET_PUBKEY];
+        if(!b || b->get_pubkey(priv_key, g_pubkey_cache.pub_key) != 0)
+        {
+            return -1;
+        }
+        memcpy(g_pubkey_cache.key_id, key_id, sizeof(key_id));
+        g_pubkey_cache.valid = 1;
+    }
+
+    memcpy(pub_key, g_pubkey_cache.pub_key, sizeof(g_pubkey_cache.pub_key));
+    return 0;
+}
+
+void ecdsa_pubkey_cache_clear()
+{
+    memset(&g_pubkey_cache, 0, sizeof(g_pubkey_cache));
+}
+
+static int hash_message(
     const uint8_t* message,
     uint32_t len,
+    uint8_t hash[32])
+{
+    if(g_engine.hash)
+    {
+        return g_engine.hash->hash(message, len, hash);
+    }
+    sha256(message, len, hash);
+    return 0;
+}
+
+#if ECDSA_VERIFY_CACHE_SIZE
+/* Recently verified signatures, each identified by the first half of
+   sha256(curve || pub_key || hash || r || s). Only successes are stored. */
+static struct
+{
+    struct
+    {
+        uint8_t valid;
+        uint8_t id[16];
+        clock_time_t stamp;
+    } entries[ECDSA_VERIFY_CACHE_SIZE];
+    uint32_t hits;
+    uint32_t misses;
+} g_verify_cache;
+
+static void verify_cache_id(
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig,
+    uint8_t id[32])
+{
+    sha256_ctx_t ctx;
+    uint8_t curve = (uint8_t)g_engine.curve;
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, &curve, 1);
+    sha256_update(&ctx, pub_key, 64);
+    sha256_update(&ctx, hash, 32);
+    sha256_update(&ctx, sig->r, 32);
+    sha256_update(&ctx, sig->s, 32);
+    sha256_final(&ctx, id);
+}
+
+static int verify_cache_live(uint8_t i, clock_time_t now)
+{
+    return g_verify_cache.entries[i].valid &&
+        (clock_time_t)(now - g_verify_cache.entries[i].stamp) < ECDSA_VERIFY_CACHE_TTL * CLOCK_SECOND;
+}
+
+static int verify_cache_find(const uint8_t id[16], clock_time_t now)
+{
+    uint8_t i;
+
+    for(i = 0; i < ECDSA_VERIFY_CACHE_SIZE; i++)
+    {
+        if(verify_cache_live(i, now) && memcmp(g_verify_cache.entries[i].id, id, 16) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Take a free or expired entry, else the oldest one. */
+static void verify_cache_add(const uint8_t id[16], clock_time_t now)
+{
+    uint8_t i;
+    uint8_t victim = 0;
+
+    for(i = 0; i < ECDSA_VERIFY_CACHE_SIZE; i++)
+    {
+        if(!verify_cache_live(i, now))
+        {
+            victim = i;
+            break;
+        }
+        if((clock_time_t)(now - g_verify_cache.entries[i].stamp) >
+           (clock_time_t)(now - g_verify_cache.entries[victim].stamp))
+        {
+            victim = i;
+        }
+    }
+
+    g_verify_cache.entries[victim].valid = 1;
+    memcpy(g_verify_cache.entries[victim].id, id, 16);
+    g_verify_cache.entries[victim].stamp = now;
+}
+#endif /* ECDSA_VERIFY_CACHE_SIZE */
+
+void ecdsa_verify_cache_stats(
+    uint32_t* hits,
+    uint32_t* misses)
+{
+#if ECDSA_VERIFY_CACHE_SIZE
+    *hits = g_verify_cache.hits;
+    *misses = g_verify_cache.misses;
+#else
+    *hits = 0;
+    *misses = 0;
+#endif
+}
+
+void ecdsa_verify_cache_clear()
+{
+#if ECDSA_VERIFY_CACHE_SIZE
+    memset(&g_verify_cache, 0, sizeof(g_verify_cache));
+#endif
+}
+
+static int verify_hash(
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
     ecdsa_signature_t* sig)
 {
+    const ecdsa_engine_backend_t* b = g_engine.selected[ECDSA_OP_VERIFY];
+    int result;
+#if ECDSA_VERIFY_CACHE_SIZE
+    uint8_t id[32];
+    clock_time_t now = clock_time();
+
+    verify_cache_id(pub_key, hash, sig, id);
+    if(verify_cache_find(id, now))
+    {
+        g_verify_cache.hits++;
+        return 0;
+    }
+    g_verify_cache.misses++;
+#endif
+
+    if(!b)
+    {
+        return -1;
+    }
+
+    /* Run the implementation of the ECDSA verify algorithm */
+    result = b->verify(pub_key, hash, sig->r, sig->s);
+
+#if ECDSA_VERIFY_CACHE_SIZE
+    if(result == 0)
+    {
+        verify_cache_add(id, now);
+    }
+#endif
+    return result;
+}
+
+/* Draw the signing nonce k for backend b. Backends that draw their own get
+   zeros; any other needs a random source, and signing fails without one
+   rather than going ahead with an unset k. */
+static int draw_nonce(const ecdsa_engine_backend_t* b, uint8_t k[32])
+{
+    if(b->caps & ECDSA_CAP_OWN_NONCE)
+    {
+        memset(k, 0, 32);
+        return 0;
+    }
+    if(!g_engine.random)
+    {
+        return -1;
+    }
+    return g_engine.random->random(k);
+}
+
+static int sign_hash(
+    const uint8_t priv_key[32],
+    const uint8_t hash[32],
+    ecdsa_signature_t* sig)
+{
+    const ecdsa_engine_backend_t* b = g_engine.selected[ECDSA_OP_SIGN];
     uint8_t k[32];
-    uint8_t hash[32];
 
-    /* Get random number k */
-    ecdsa_impl_random(k);
+    if(!b)
+    {
+        return -1;
+    }
 
-    /* Compute the message hash */
-    ecdsa_impl_hash(message, len, hash);
+    /* Get random number k */
+    if(draw_nonce(b, k) != 0)
+    {
+        return -1;
+    }
 
     /* Run the implementation of the ECDSA sign algorithm */
-    ecdsa_impl_sign(priv_key, k, hash, sig->r, sig->s);
+    return b->sign(priv_key, k, hash, sig->r, sig->s);
+}
 
-    return 0;
+int ecdsa_sign(
+    const uint8_t priv_key[32],
+    const uint8_t* message,
+    uint32_t len,
+    ecdsa_signature_t* sig)
+{
+    uint8_t hash[32];
 
+    /* Compute the message hash */
+    if(hash_message(message, len, hash) != 0)
+    {
+        return -1;
+    }
+
+    return sign_hash(priv_key, hash, sig);
 }
 
 
@@ -75,12 +615,436 @@ int ecdsa_verify(
     uint8_t hash[32];
 
     /* Compute the message hash */
-    ecdsa_impl_hash(message, len, hash);
+    if(hash_message(message, len, hash) != 0)
+    {
+        return -1;
+    }
 
-    /* Run the implementation of the ECDSA verify algorithm */
-    ecdsa_impl_verify(pub_key, hash, sig->r, sig->s);
+    return verify_hash(pub_key, hash, sig);
+}
 
+int ecdsa_sign_batch(
+    const uint8_t priv_key[32],
+    const uint8_t hashes[][32],
+    ecdsa_signature_t sigs[],
+    uint32_t count)
+{
+    const ecdsa_engine_backend_t* b = g_engine.selected[ECDSA_OP_SIGN];
+    uint32_t i;
+
+    if(!b)
+    {
+        return -1;
+    }
+    if(b->sign_batch)
+    {
+        return b->sign_batch(priv_key, hashes, sigs, count);
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        if(sign_hash(priv_key, hashes[i], &sigs[i]) != 0)
+        {
+            return -1;
+        }
+    }
     return 0;
+}
+
+/* Hash the fragments in order. The backend hash op only takes a contiguous
+   message, so this always streams through the software SHA-256. */
+static void hash_iov(
+    const ecdsa_iovec_t* iov,
+    uint32_t iovcnt,
+    uint8_t hash[32])
+{
+    sha256_ctx_t ctx;
+    uint32_t i;
+
+    sha256_init(&ctx);
+    for(i = 0; i < iovcnt; i++)
+    {
+        sha256_update(&ctx, iov[i].base, iov[i].len);
+    }
+    sha256_final(&ctx, hash);
+}
+
+int ecdsa_sign_iov(
+    const uint8_t priv_key[32],
+    const ecdsa_iovec_t* iov,
+    uint32_t iovcnt,
+    ecdsa_signature_t* sig)
+{
+    uint8_t hash[32];
+
+    hash_iov(iov, iovcnt, hash);
+
+    return sign_hash(priv_key, hash, sig);
+}
+
+int ecdsa_verify_iov(
+    const uint8_t pub_key[64],
+    const ecdsa_iovec_t* iov,
+    uint32_t iovcnt,
+    ecdsa_signature_t* sig)
+{
+    uint8_t hash[32];
+
+    hash_iov(iov, iovcnt, hash);
+
+    return verify_hash(pub_key, hash, sig);
+}
+
+int ecdsa_recover(
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig,
+    int recid,
+    uint8_t pub_key[64])
+{
+    const ecdsa_engine_backend_t* b = ecdsa_engine_find(ECDSA_CAP_RECOVERY);
+
+    if(!b || !b->recover)
+    {
+        return -1;
+    }
+    return b->recover(hash, sig->r, sig->s, recid, pub_key);
+}
+
+/* Backend for resumable operations: the selected one if it can step,
+   otherwise the first usable backend that can. */
+static const ecdsa_engine_backend_t* step_backend(ecdsa_engine_op_t op)
+{
+    const ecdsa_engine_backend_t* b = g_engine.selected[op];
+    uint8_t i;
+
+#define CAN_STEP(b) ((op == ECDSA_OP_SIGN) ? ((b)->sign_step != NULL) : ((b)->verify_step != NULL))
+    if(b && CAN_STEP(b))
+    {
+        return b;
+    }
+    for(i = 0; i < g_engine.count; ++i)
+    {
+        if(backend_ok(i) && CAN_STEP(g_engine.backends[i]))
+        {
+            return g_engine.backends[i];
+        }
+    }
+#undef CAN_STEP
+    return NULL;
+}
+
+int ecdsa_sign_begin(
+    ecdsa_sign_ctx_t* ctx,
+    const uint8_t priv_key[32],
+    const uint8_t hash[32])
+{
+    uint8_t k[32];
+
+    ctx->backend = step_backend(ECDSA_OP_SIGN);
+    if(!ctx->backend)
+    {
+        /* Nothing can step: sign now, report it on the first step. */
+        ctx->status = sign_hash(priv_key, hash, &ctx->sig);
+        return ctx->status;
+    }
+
+    if(draw_nonce(ctx->backend, k) != 0)
+    {
+        ctx->status = -1;
+        return -1;
+    }
+
+    ctx->status = (ctx->backend->sign_begin(ctx->work, priv_key, k, hash) == 0) ?
+        ECDSA_STEP_AGAIN : -1;
+    memset(k, 0, sizeof(k));
+    return (ctx->status == -1) ? -1 : 0;
+}
+
+int ecdsa_sign_step(ecdsa_sign_ctx_t* ctx)
+{
+    if(ctx->status == ECDSA_STEP_AGAIN)
+    {
+        ctx->status = ctx->backend->sign_step(ctx->work, ECDSA_STEP_ITERATIONS,
+            ctx->sig.r, ctx->sig.s);
+    }
+    return ctx->status;
+}
+
+int ecdsa_sign_result(
+    ecdsa_sign_ctx_t* ctx,
+    ecdsa_signature_t* sig)
+{
+    if(ctx->status == 0)
+    {
+        memcpy(sig, &ctx->sig, sizeof(*sig));
+    }
+    return ctx->status;
+}
 
+void ecdsa_sign_abort(ecdsa_sign_ctx_t* ctx)
+{
+    if(ctx->status == ECDSA_STEP_AGAIN && ctx->backend->cancel)
+    {
+        ctx->backend->cancel(ctx->work);
+    }
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->status = -1;
 }
 
+int ecdsa_verify_begin(
+    ecdsa_verify_ctx_t* ctx,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig)
+{
+    ctx->backend = step_backend(ECDSA_OP_VERIFY);
+    if(!ctx->backend)
+    {
+        ctx->status = verify_hash(pub_key, hash, (ecdsa_signature_t*)sig);
+        return 0;
+    }
+
+    ctx->status = (ctx->backend->verify_begin(ctx->work, pub_key, hash, sig->r, sig->s) == 0) ?
+        ECDSA_STEP_AGAIN : -1;
+    return (ctx->status == -1) ? -1 : 0;
+}
+
+int ecdsa_verify_step(ecdsa_verify_ctx_t* ctx)
+{
+    if(ctx->status == ECDSA_STEP_AGAIN)
+    {
+        ctx->status = ctx->backend->verify_step(ctx->work, ECDSA_STEP_ITERATIONS);
+    }
+    return ctx->status;
+}
+
+int ecdsa_verify_result(ecdsa_verify_ctx_t* ctx)
+{
+    return ctx->status;
+}
+
+void ecdsa_verify_abort(ecdsa_verify_ctx_t* ctx)
+{
+    if(ctx->status == ECDSA_STEP_AGAIN && ctx->backend->cancel)
+    {
+        ctx->backend->cancel(ctx->work);
+    }
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->status = -1;
+}
+
+/* Produce item index's digest and nonce. This is the CPU work that overlaps
+   the previous item's point arithmetic. */
+static void pipeline_prepare(ecdsa_pipeline_t* p, uint32_t index)
+{
+    ecdsa_pipeline_stage_t* stage = &p->stages[index & 1];
+
+    stage->status = p->hash(p->arg, index, stage->hash);
+    if(stage->status == 0 && draw_nonce(p->sign.backend, stage->k) != 0)
+    {
+        stage->status = -1;
+    }
+}
+
+/* Start signing the current item, whose stage is ready, then prepare the
+   next one while the backend works on it. */
+static void pipeline_start(ecdsa_pipeline_t* p)
+{
+    const ecdsa_engine_backend_t* b = p->sign.backend;
+    ecdsa_pipeline_stage_t* cur = &p->stages[p->index & 1];
+
+    if(cur->status != 0)
+    {
+        p->sign.status = -1;
+    }
+    else if(b->sign_begin)
+    {
+        p->sign.status = (b->sign_begin(p->sign.work, p->priv_key, cur->k, cur->hash) == 0) ?
+            ECDSA_STEP_AGAIN : -1;
+    }
+    else
+    {
+        /* Nothing can step: sign now, report it on the next step. */
+        p->sign.status = b->sign(p->priv_key, cur->k, cur->hash, p->sign.sig.r, p->sign.sig.s);
+    }
+    memset(cur->k, 0, sizeof(cur->k));
+
+    if(p->index + 1 < p->count)
+    {
+        pipeline_prepare(p, p->index + 1);
+    }
+}
+
+int ecdsa_pipeline_begin(
+    ecdsa_pipeline_t* p,
+    const uint8_t priv_key[32],
+    uint32_t count,
+    ecdsa_pipeline_hash_fn hash,
+    ecdsa_pipeline_done_fn done,
+    void* arg)
+{
+    const ecdsa_engine_backend_t* b = ecdsa_engine_find(ECDSA_CAP_ASYNC);
+
+    memset(p, 0, sizeof(*p));
+    p->result = -1;
+    if(!b || !b->sign_begin)
+    {
+        b = step_backend(ECDSA_OP_SIGN);
+    }
+    if(!b)
+    {
+        b = g_engine.selected[ECDSA_OP_SIGN];
+    }
+    if(!b)
+    {
+        return -1;
+    }
+
+    p->priv_key = priv_key;
+    p->count = count;
+    p->hash = hash;
+    p->done = done;
+    p->arg = arg;
+    p->result = 0;
+    p->sign.backend = b;
+
+    if(count)
+    {
+        pipeline_prepare(p, 0);
+        pipeline_start(p);
+    }
+    return 0;
+}
+
+int ecdsa_pipeline_step(ecdsa_pipeline_t* p)
+{
+    if(p->index >= p->count)
+    {
+        return p->result;
+    }
+    if(ecdsa_sign_step(&p->sign) == ECDSA_STEP_AGAIN)
+    {
+        return ECDSA_STEP_AGAIN;
+    }
+
+    if(p->sign.status != 0)
+    {
+        p->sign.status = -1;
+        p->result = -1;
+    }
+    p->done(p->arg, p->index, p->sign.status, &p->sign.sig);
+
+    if(++p->index < p->count)
+    {
+        pipeline_start(p);
+        return ECDSA_STEP_AGAIN;
+    }
+
+    memset(p->stages, 0, sizeof(p->stages));
+    memset(&p->sign, 0, sizeof(p->sign));
+    return p->result;
+}
+
+void ecdsa_pipeline_abort(ecdsa_pipeline_t* p)
+{
+    ecdsa_sign_abort(&p->sign);
+    memset(p, 0, sizeof(*p));
+    p->result = -1;
+}
+
+void ecdsa_trx_digest_init(
+    ecdsa_trx_digest_t* digest,
+    const uint8_t chain_id[32])
+{
+    sha256_init(&digest->id);
+    sha256_init(&digest->sig);
+    sha256_update(&digest->sig, chain_id, 32);
+}
+
+void ecdsa_trx_digest_update(
+    ecdsa_trx_digest_t* digest,
+    const uint8_t* chunk,
+    uint32_t len)
+{
+    /* Feed both contexts slice by slice so a large chunk is read back
+       from cache for the second context rather than from memory. */
+    while(len)
+    {
+        uint32_t n = (len < TRX_DIGEST_SLICE) ? len : TRX_DIGEST_SLICE;
+        sha256_update(&digest->id, chunk, n);
+        sha256_update(&digest->sig, chunk, n);
+        chunk += n;
+        len -= n;
+    }
+}
+
+int ecdsa_sign_trx(
+    const uint8_t priv_key[32],
+    ecdsa_trx_digest_t* digest,
+    const uint8_t cfd_hash[32],
+    uint8_t trx_id[32],
+    ecdsa_signature_t* sig)
+{
+    uint8_t hash[32];
+
+    if(trx_id)
+    {
+        sha256_final(&digest->id, trx_id);
+    }
+
+    sha256_update(&digest->sig, cfd_hash, 32);
+    sha256_final(&digest->sig, hash);
+
+    return sign_hash(priv_key, hash, sig);
+}
+
+void ecdsa_digest_init(ecdsa_digest_t* digest)
+{
+    sha256_init(&digest->sha);
+}
+
+void ecdsa_digest_update(
+    ecdsa_digest_t* digest,
+    const uint8_t* chunk,
+    uint32_t len)
+{
+    sha256_update(&digest->sha, chunk, len);
+}
+
+void ecdsa_digest_save(
+    const ecdsa_digest_t* digest,
+    ecdsa_digest_midstate_t* mid)
+{
+    sha256_save(&digest->sha, &mid->sha);
+}
+
+void ecdsa_digest_restore(
+    ecdsa_digest_t* digest,
+    const ecdsa_digest_midstate_t* mid)
+{
+    sha256_restore(&digest->sha, &mid->sha);
+}
+
+int ecdsa_sign_digest(
+    const uint8_t priv_key[32],
+    ecdsa_digest_t* digest,
+    ecdsa_signature_t* sig)
+{
+    uint8_t hash[32];
+
+    sha256_final(&digest->sha, hash);
+
+    return sign_hash(priv_key, hash, sig);
+}
+
+int ecdsa_verify_digest(
+    const uint8_t pub_key[64],
+    ecdsa_digest_t* digest,
+    ecdsa_signature_t* sig)
+{
+    uint8_t hash[32];
+
+    sha256_final(&digest->sha, hash);
+
+    return verify_hash(pub_key, hash, sig);
+}
@@ -35,18 +35,164 @@
 #ifndef __ECDSA_ENGINE_H
 #define __ECDSA_ENGINE_H
 
+#include <stdint.h>
+#include "ecdsa-engines/sw/sha256.h"
+
 typedef struct
 {
     uint8_t r[32];
     uint8_t s[32];
 } ecdsa_signature_t;
 
+/* Curves the engine knows about, for range checks and backend selection. */
+typedef enum
+{
+    ECDSA_CURVE_SECP256K1,
+    ECDSA_CURVE_SECP256R1
+} ecdsa_curve_t;
+
+/* ECDSA_ENGINE_MAX_BACKENDS - Number of backends that can be registered.
+   Override with ECDSA_ENGINE_CONF_MAX_BACKENDS. */
+#ifdef ECDSA_ENGINE_CONF_MAX_BACKENDS
+#define ECDSA_ENGINE_MAX_BACKENDS ECDSA_ENGINE_CONF_MAX_BACKENDS
+#else
+#define ECDSA_ENGINE_MAX_BACKENDS 4
+#endif
+
+/* ECDSA_ENGINE_WITH_CC26X2 - If enabled (defined as nonzero), ecdsa_init()
+   registers the CC26x2 PKA backend alongside uECC. It is only used on boards
+   where the PKA driver opens. Override with ECDSA_ENGINE_CONF_WITH_CC26X2. */
+#ifdef ECDSA_ENGINE_CONF_WITH_CC26X2
+#define ECDSA_ENGINE_WITH_CC26X2 ECDSA_ENGINE_CONF_WITH_CC26X2
+#else
+#define ECDSA_ENGINE_WITH_CC26X2 1
+#endif
+
+/* ECDSA_ENGINE_DEFAULT_CURVE - Curve selected by ecdsa_init().
+   Override with ECDSA_ENGINE_CONF_DEFAULT_CURVE. */
+#ifdef ECDSA_ENGINE_CONF_DEFAULT_CURVE
+#define ECDSA_ENGINE_DEFAULT_CURVE ECDSA_ENGINE_CONF_DEFAULT_CURVE
+#else
+#define ECDSA_ENGINE_DEFAULT_CURVE ECDSA_CURVE_SECP256K1
+#endif
+
+/* ECDSA_STEP_ITERATIONS - Loop iterations per ecdsa_sign_step() or
+   ecdsa_verify_step() call: comb columns when signing (64 in all), scalar
+   bits when verifying (about 256). Smaller values keep each step shorter.
+   Override with ECDSA_CONF_STEP_ITERATIONS. */
+#ifdef ECDSA_CONF_STEP_ITERATIONS
+#define ECDSA_STEP_ITERATIONS ECDSA_CONF_STEP_ITERATIONS
+#else
+#define ECDSA_STEP_ITERATIONS 4
+#endif
+
+/* ECDSA_VERIFY_CACHE_SIZE - Number of successful verifications remembered
+   so that a retransmitted copy of a signed message is accepted without
+   another scalar multiplication. 0 disables the cache.
+   Override with ECDSA_CONF_VERIFY_CACHE_SIZE. */
+#ifdef ECDSA_CONF_VERIFY_CACHE_SIZE
+#define ECDSA_VERIFY_CACHE_SIZE ECDSA_CONF_VERIFY_CACHE_SIZE
+#else
+#define ECDSA_VERIFY_CACHE_SIZE 8
+#endif
+
+/* ECDSA_VERIFY_CACHE_TTL - Seconds a cached verification stays valid.
+   Override with ECDSA_CONF_VERIFY_CACHE_TTL. */
+#ifdef ECDSA_CONF_VERIFY_CACHE_TTL
+#define ECDSA_VERIFY_CACHE_TTL ECDSA_CONF_VERIFY_CACHE_TTL
+#else
+#define ECDSA_VERIFY_CACHE_TTL 60
+#endif
+
+/* Backend working storage in a resumable signing or verify context. */
+#define ECDSA_STEP_CTX_SIZE 384
+
+/* Returned by the step functions while more work remains. */
+#define ECDSA_STEP_AGAIN    1
+
+/* Operations for which the engine selects a backend. */
+typedef enum
+{
+    ECDSA_OP_GET_PUBKEY,
+    ECDSA_OP_SIGN,
+    ECDSA_OP_VERIFY,
+    ECDSA_OP_COUNT
+} ecdsa_engine_op_t;
+
+/* Backend vtable, see ecdsa-engines/ecdsa-engine-impl.h. */
+typedef struct ecdsa_engine_backend ecdsa_engine_backend_t;
+
 
 /**
- * Invoke implementation initialization as necessary.
+ * Register the built-in backends, initialize them, select the default curve
+ * and calibrate. Backends registered beforehand with ecdsa_engine_register()
+ * are included.
  */
 void ecdsa_init();
 
+/**
+ *  Add a backend to the registry. Call before ecdsa_init().
+ *
+ *  @return 0 - success, -1 if the registry is full.
+ */
+int ecdsa_engine_register(const ecdsa_engine_backend_t* backend);
+
+/**
+ *  Time each usable backend on a fixed test vector on the current curve and
+ *  select the fastest one for each operation. Backends whose results do not
+ *  agree with the others are not selected. Runs as part of ecdsa_init();
+ *  call it again to rank backends that lack the curve calibrated there.
+ */
+void ecdsa_engine_calibrate();
+
+/**
+ *  Backend selected for an operation, NULL if none supports it.
+ */
+const ecdsa_engine_backend_t* ecdsa_engine_selected(ecdsa_engine_op_t op);
+
+/**
+ *  Calibration time of the selected backend for an operation, in rtimer ticks.
+ */
+uint32_t ecdsa_engine_ticks(ecdsa_engine_op_t op);
+
+/**
+ *  First usable backend having all of the given ECDSA_CAP_* flags for the
+ *  current curve, NULL if there is none.
+ */
+const ecdsa_engine_backend_t* ecdsa_engine_find(uint8_t caps);
+
+/**
+ *  Select the curve for all backends. The selection made by calibration is
+ *  kept, less the backends that do not support the curve; no backend is
+ *  timed again.
+ *
+ *  @return 0 - success, -1 if no backend supports the curve.
+ */
+int ecdsa_set_curve(ecdsa_curve_t curve);
+
+/**
+ *  Curve currently selected.
+ */
+ecdsa_curve_t ecdsa_get_curve();
+
+/**
+ *  Get the public key for the device's private key. It is derived on the
+ *  first call and cached, so later calls with the same private key just
+ *  copy out the stored point.
+ *
+ *  @param(pub_key) [out] public key, x followed by y.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_get_pubkey(
+    const uint8_t priv_key[32],
+    uint8_t pub_key[64]);
+
+/**
+ *  Forget the cached public key, e.g. after the private key is replaced.
+ */
+void ecdsa_pubkey_cache_clear();
+
 /**
  *  Create an ECDSA signature for the specified message given the
  *  device's private key.
@@ -75,7 +221,379 @@ int ecdsa_verify(
     uint32_t len,
     ecdsa_signature_t* sig);
 
+/**
+ *  One fragment of a message held in several separate buffers.
+ */
+typedef struct
+{
+    const uint8_t* base;
+    uint32_t len;
+} ecdsa_iovec_t;
+
+/**
+ *  As ecdsa_sign(), for a message made of iovcnt fragments taken in order,
+ *  e.g. a cached header, an action prefix and sensor payload pieces. The
+ *  fragments are streamed through SHA-256 where they lie; no contiguous
+ *  copy of the message is made.
+ *
+ *  @param(sig) [out] generated message signature.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_sign_iov(
+    const uint8_t priv_key[32],
+    const ecdsa_iovec_t* iov,
+    uint32_t iovcnt,
+    ecdsa_signature_t* sig);
+
+/**
+ *  As ecdsa_verify(), for a message made of iovcnt fragments taken in order.
+ *
+ *  @param(sig) [in] message signature.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_verify_iov(
+    const uint8_t pub_key[64],
+    const ecdsa_iovec_t* iov,
+    uint32_t iovcnt,
+    ecdsa_signature_t* sig);
+
+/**
+ *  Sign count hashes with the same private key, e.g. a backlog of queued
+ *  readings. A backend that can share work between the signatures (key
+ *  parsing, nonce inversions) does so; otherwise each hash is signed in turn.
+ *
+ *  @param(sigs) [out] count generated signatures.
+ *
+ *  @return 0 - success, -1 if any signature could not be made.
+ */
+int ecdsa_sign_batch(
+    const uint8_t priv_key[32],
+    const uint8_t hashes[][32],
+    ecdsa_signature_t sigs[],
+    uint32_t count);
+
+/**
+ *  Lookups of the verification cache since startup or the last clear:
+ *  hits accepted without verifying, misses verified by a backend.
+ */
+void ecdsa_verify_cache_stats(
+    uint32_t* hits,
+    uint32_t* misses);
+
+/**
+ *  Forget all cached verifications and reset the counters, e.g. after a
+ *  key is revoked.
+ */
+void ecdsa_verify_cache_clear();
+
+/**
+ *  Recover the signer's public key from a signature over a hash. Needs a
+ *  backend with ECDSA_CAP_RECOVERY.
+ *
+ *  @param(recid) [in] recovery id 0..3.
+ *  @param(pub_key) [out] public key, x followed by y.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_recover(
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig,
+    int recid,
+    uint8_t pub_key[64]);
+
+/**
+ *  Resumable signing context. The scalar multiplication state lives here
+ *  between steps so the caller can yield to the scheduler.
+ */
+typedef struct
+{
+    const ecdsa_engine_backend_t* backend;
+    int status;
+    ecdsa_signature_t sig;
+    uint64_t work[ECDSA_STEP_CTX_SIZE / 8];
+} ecdsa_sign_ctx_t;
+
+/**
+ *  Resumable verification context.
+ */
+typedef struct
+{
+    const ecdsa_engine_backend_t* backend;
+    int status;
+    uint64_t work[ECDSA_STEP_CTX_SIZE / 8];
+} ecdsa_verify_ctx_t;
+
+/**
+ *  Start signing a hash incrementally. Uses the first backend that supports
+ *  resumable signing; if there is none the signature is computed here in
+ *  one go and the first step just reports it.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_sign_begin(
+    ecdsa_sign_ctx_t* ctx,
+    const uint8_t priv_key[32],
+    const uint8_t hash[32]);
+
+/**
+ *  Do the next ECDSA_STEP_ITERATIONS of signing work.
+ *
+ *  @return ECDSA_STEP_AGAIN - call again, 0 - done, -1 - failed.
+ */
+int ecdsa_sign_step(ecdsa_sign_ctx_t* ctx);
+
+/**
+ *  Fetch the signature once ecdsa_sign_step() has returned 0.
+ *
+ *  @return 0 - success, ECDSA_STEP_AGAIN if unfinished, -1 if signing failed.
+ */
+int ecdsa_sign_result(
+    ecdsa_sign_ctx_t* ctx,
+    ecdsa_signature_t* sig);
+
+/**
+ *  Wipe a signing context, e.g. one abandoned part way through. A backend
+ *  still working on it in the background is stopped first.
+ */
+void ecdsa_sign_abort(ecdsa_sign_ctx_t* ctx);
+
+/**
+ *  Start verifying a signature over a hash incrementally.
+ *
+ *  @return 0 - started, -1 if the signature is rejected outright.
+ */
+int ecdsa_verify_begin(
+    ecdsa_verify_ctx_t* ctx,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig);
+
+/**
+ *  Do the next ECDSA_STEP_ITERATIONS of verification work.
+ *
+ *  @return ECDSA_STEP_AGAIN - call again, 0 - valid, -1 - invalid.
+ */
+int ecdsa_verify_step(ecdsa_verify_ctx_t* ctx);
+
+/**
+ *  Outcome once ecdsa_verify_step() has stopped returning ECDSA_STEP_AGAIN.
+ *
+ *  @return 0 - valid, -1 - invalid, ECDSA_STEP_AGAIN if unfinished.
+ */
+int ecdsa_verify_result(ecdsa_verify_ctx_t* ctx);
+
+/**
+ *  Wipe a verification context abandoned part way through, stopping a
+ *  backend still working on it in the background.
+ */
+void ecdsa_verify_abort(ecdsa_verify_ctx_t* ctx);
+
+/**
+ *  Produce the signing digest of stream item index, typically by serializing
+ *  the transaction through an ecdsa_digest_t.
+ *
+ *  @return 0 - success, -1 to skip the item.
+ */
+typedef int (*ecdsa_pipeline_hash_fn)(
+    void* arg,
+    uint32_t index,
+    uint8_t hash[32]);
+
+/**
+ *  Receive the signature of stream item index. status is 0 if sig is valid,
+ *  -1 if the item was skipped or could not be signed.
+ */
+typedef void (*ecdsa_pipeline_done_fn)(
+    void* arg,
+    uint32_t index,
+    int status,
+    const ecdsa_signature_t* sig);
+
+/**
+ *  One item of a signing pipeline: its digest and nonce, prepared while the
+ *  previous item is being signed.
+ */
+typedef struct
+{
+    uint8_t hash[32];
+    uint8_t k[32];
+    int status;
+} ecdsa_pipeline_stage_t;
+
+/**
+ *  Signing pipeline, owned by the caller and kept in place until it
+ *  finishes or is aborted.
+ */
+typedef struct
+{
+    const uint8_t* priv_key;
+    uint32_t count;
+    ecdsa_pipeline_hash_fn hash;
+    ecdsa_pipeline_done_fn done;
+    void* arg;
+    uint32_t index;             /* item being signed */
+    int result;
+    ecdsa_pipeline_stage_t stages[2];
+    ecdsa_sign_ctx_t sign;
+} ecdsa_pipeline_t;
+
+/**
+ *  Start signing a stream of count items under one key, overlapping the CPU
+ *  stages of item N+1 (serializing, hashing, drawing the nonce) with the
+ *  point arithmetic of item N. The overlap happens when a backend with
+ *  ECDSA_CAP_ASYNC signs in the background, e.g. the CC26x2 PKA; otherwise
+ *  the items are signed one after another by the resumable backend.
+ *  Signatures are delivered in order, from ecdsa_pipeline_step(). Run it
+ *  from a process with ecdsa_pipeline_pt().
+ *
+ *  @return 0 - started, -1 if no backend can sign.
+ */
+int ecdsa_pipeline_begin(
+    ecdsa_pipeline_t* p,
+    const uint8_t priv_key[32],
+    uint32_t count,
+    ecdsa_pipeline_hash_fn hash,
+    ecdsa_pipeline_done_fn done,
+    void* arg);
+
+/**
+ *  Do the next ECDSA_STEP_ITERATIONS of signing work, delivering the
+ *  current item and starting the next once it is signed.
+ *
+ *  @return ECDSA_STEP_AGAIN - call again, 0 - every item was signed,
+ *          -1 if any failed.
+ */
+int ecdsa_pipeline_step(ecdsa_pipeline_t* p);
+
+/**
+ *  Stop a pipeline part way through and wipe it. Items not yet delivered
+ *  are dropped.
+ */
+void ecdsa_pipeline_abort(ecdsa_pipeline_t* p);
+
+/**
+ *  Transaction digest pair computed in a single pass over the serialized
+ *  transaction: the transaction ID sha256(packed_trx) and the signing
+ *  digest sha256(chain_id || packed_trx || cfd_hash).
+ */
+typedef struct
+{
+    sha256_ctx_t id;
+    sha256_ctx_t sig;
+} ecdsa_trx_digest_t;
+
+/**
+ *  Start a transaction digest pair for the given chain.
+ */
+void ecdsa_trx_digest_init(
+    ecdsa_trx_digest_t* digest,
+    const uint8_t chain_id[32]);
+
+/**
+ *  Absorb the next serialized chunk of the packed transaction into both
+ *  digests while it is still hot in cache.
+ */
+void ecdsa_trx_digest_update(
+    ecdsa_trx_digest_t* digest,
+    const uint8_t* chunk,
+    uint32_t len);
+
+/**
+ *  Finish both digests and sign the transaction with the device's private key.
+ *  The digest must be re-initialized before it is used again.
+ *
+ *  @param(cfd_hash) [in] context-free data hash, ecdsa_empty_cfd_hash if none.
+ *  @param(trx_id) [out] transaction ID. May be NULL if not wanted.
+ *  @param(sig) [out] generated transaction signature.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_sign_trx(
+    const uint8_t priv_key[32],
+    ecdsa_trx_digest_t* digest,
+    const uint8_t cfd_hash[32],
+    uint8_t trx_id[32],
+    ecdsa_signature_t* sig);
+
+/**
+ *  Running message digest. Lets a transaction be hashed chunk by chunk
+ *  while it is serialized instead of after it is assembled in RAM.
+ */
+typedef struct
+{
+    sha256_ctx_t sha;
+} ecdsa_digest_t;
+
+/**
+ *  Digest state saved after a message prefix that does not change between
+ *  transactions, e.g. chain_id followed by the packed transaction header.
+ */
+typedef struct
+{
+    sha256_midstate_t sha;
+} ecdsa_digest_midstate_t;
 
+/**
+ *  Context-free data hash that ends the EOS signing digest
+ *  sha256(chain_id || packed_trx || cfd_hash) when a transaction carries
+ *  no context-free data. It is 32 zero bytes, not the hash of an empty input.
+ */
+extern const uint8_t ecdsa_empty_cfd_hash[32];
 
+/**
+ * Start a new message digest.
+ */
+void ecdsa_digest_init(ecdsa_digest_t* digest);
+
+/**
+ * Absorb the next serialized chunk of the message.
+ */
+void ecdsa_digest_update(
+    ecdsa_digest_t* digest,
+    const uint8_t* chunk,
+    uint32_t len);
+
+/**
+ *  Save the digest state, typically once the invariant prefix of the
+ *  transaction has been absorbed. The digest may continue to be updated.
+ */
+void ecdsa_digest_save(
+    const ecdsa_digest_t* digest,
+    ecdsa_digest_midstate_t* mid);
+
+/**
+ *  Resume a digest from a saved state so that only the bytes following the
+ *  prefix need to be hashed. One saved state may be restored any number of times.
+ */
+void ecdsa_digest_restore(
+    ecdsa_digest_t* digest,
+    const ecdsa_digest_midstate_t* mid);
+
+/**
+ *  Finish the digest and sign it with the device's private key.
+ *  The digest must be re-initialized before it is used again.
+ *
+ *  @param(sig) [out] generated message signature.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_sign_digest(
+    const uint8_t priv_key[32],
+    ecdsa_digest_t* digest,
+    ecdsa_signature_t* sig);
+
+/**
+ *  Finish the digest and verify it against the sender's public key.
+ *
+ *  @param(sig) [in] message signature.
+ *
+ *  @return 0 - success
+ */
+int ecdsa_verify_digest(
+    const uint8_t pub_key[64],
+    ecdsa_digest_t* digest,
+    ecdsa_signature_t* sig);
 
 #endif // __ECDSA_ENGINE_H
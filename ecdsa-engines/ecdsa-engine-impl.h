@@ -27,6 +27,8 @@
 /**
 * \file
 *    Implementation definitions for EOS transaction signing engine components.
+*    Each backend describes itself with an ecdsa_engine_backend_t and is
+*    registered with the engine, which picks one backend per operation.
 *
 * \author
 *    Evan Ross <contact@firmwaremodules.com>
@@ -35,32 +37,116 @@
 #ifndef __ECDSA_ENGINE_IMPL_H
 #define __ECDSA_ENGINE_IMPL_H
 
+#include <stdint.h>
+#include "ecdsa-engine.h"
 
-/* Initialize engine. */
-void ecdsa_impl_init();
-
-/* Get random number k for signing algorithm .*/
-int ecdsa_impl_random(uint8_t k[32]);
-
-/* Get the SHA-256 hash of the message. */
-int ecdsa_impl_hash(
-    const uint8_t* message,
-    uint32_t len,
-    uint8_t hash[32]);
-
-/* Compute the ECDSA signature using the secp256k1 curve. */
-int ecdsa_impl_sign(
-    const uint8_t priv_key[32],
-    const uint8_t k[32],
-    const uint8_t hash[32],
-    uint8_t r[32],
-    uint8_t s[32]);
-
-/* Verify the ECDSA signature using the secp256k1 curve. */
-int ecdsa_impl_verify(
-    const uint8_t pub_key[64],
-    const uint8_t hash[32],
-    uint8_t r[32],
-    uint8_t s[32]);
+/* Backend capability flags. */
+#define ECDSA_CAP_SECP256K1     0x01    /* supports secp256k1 */
+#define ECDSA_CAP_SECP256R1     0x02    /* supports secp256r1 (NIST P-256) */
+#define ECDSA_CAP_RECOVERY      0x04    /* can recover a public key from a signature */
+#define ECDSA_CAP_ASYNC         0x08    /* can complete operations in the background */
+#define ECDSA_CAP_OWN_NONCE     0x10    /* draws its own signing nonce and ignores k */
+
+#define ECDSA_CAP_CURVE(curve) \
+    (((curve) == ECDSA_CURVE_SECP256R1) ? ECDSA_CAP_SECP256R1 : ECDSA_CAP_SECP256K1)
+
+/* Backend operations. All byte strings are big-endian, public keys are x
+   followed by y. Functions return 0 on success. Optional operations are
+   NULL when the backend does not provide them. */
+struct ecdsa_engine_backend
+{
+    const char* name;
+    uint8_t caps;
+
+    /* Initialize the backend. Returns -1 if it is not usable on this board. */
+    int (*init)(void);
+
+    /* Select the curve for subsequent operations. */
+    int (*set_curve)(ecdsa_curve_t curve);
+
+    /* Get random number k for signing algorithm. Optional. */
+    int (*random)(uint8_t k[32]);
+
+    /* Get the SHA-256 hash of the message. */
+    int (*hash)(
+        const uint8_t* message,
+        uint32_t len,
+        uint8_t hash[32]);
+
+    /* Derive the public key belonging to a private key. Optional. */
+    int (*get_pubkey)(
+        const uint8_t priv_key[32],
+        uint8_t pub_key[64]);
+
+    /* Compute the ECDSA signature. Backends with their own nonce source
+       set ECDSA_CAP_OWN_NONCE and ignore k. */
+    int (*sign)(
+        const uint8_t priv_key[32],
+        const uint8_t k[32],
+        const uint8_t hash[32],
+        uint8_t r[32],
+        uint8_t s[32]);
+
+    /* Verify the ECDSA signature. */
+    int (*verify)(
+        const uint8_t pub_key[64],
+        const uint8_t hash[32],
+        uint8_t r[32],
+        uint8_t s[32]);
+
+    /* Sign count hashes under one key, optional. Backends that share work
+       between the signatures provide this; the engine otherwise signs them
+       one at a time. The nonces come from the backend's own source. */
+    int (*sign_batch)(
+        const uint8_t priv_key[32],
+        const uint8_t hashes[][32],
+        ecdsa_signature_t sigs[],
+        uint32_t count);
+
+    /* Recover the signer's public key, optional; ECDSA_CAP_RECOVERY. */
+    int (*recover)(
+        const uint8_t hash[32],
+        const uint8_t r[32],
+        const uint8_t s[32],
+        int recid,
+        uint8_t pub_key[64]);
+
+    /* Resumable signing and verification, optional. ctx is
+       ECDSA_STEP_CTX_SIZE bytes of backend-private, 8-byte aligned storage.
+       The step functions do at most the given number of loop iterations and
+       return ECDSA_STEP_AGAIN until finished, then 0 for a signature made
+       or valid, -1 otherwise. */
+    int (*sign_begin)(
+        void* ctx,
+        const uint8_t priv_key[32],
+        const uint8_t k[32],
+        const uint8_t hash[32]);
+
+    int (*sign_step)(
+        void* ctx,
+        unsigned iterations,
+        uint8_t r[32],
+        uint8_t s[32]);
+
+    int (*verify_begin)(
+        void* ctx,
+        const uint8_t pub_key[64],
+        const uint8_t hash[32],
+        const uint8_t r[32],
+        const uint8_t s[32]);
+
+    int (*verify_step)(
+        void* ctx,
+        unsigned iterations);
+
+    /* Abandon a resumable operation part way through, optional. Backends
+       that compute in the background stop and let go of ctx before
+       returning, so the caller may wipe or reuse it. */
+    void (*cancel)(void* ctx);
+};
+
+/* Backends built into the engine. */
+extern const ecdsa_engine_backend_t ecdsa_uecc_backend;
+extern const ecdsa_engine_backend_t ecdsa_cc26x2_backend;
 
 #endif
@@ -36,12 +36,16 @@
 #include "dev/watchdog.h"
 #include "sys/clock.h"
 
-#include "ecdsa-engines\ecdsa-engine-impl.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
 #include <ti/devices/DeviceFamily.h>
 #include DeviceFamily_constructPath(driverlib/pka.h)
 #include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
 #include <ti/drivers/ECDSA.h>
 #include "ecdsa-cc26x2-adapter.h"
+#include "ecdsa-engines/sw/sha256.h"
+#include "perf-cycles.h"
+#include <stdio.h>
+#include <string.h>
 
 #define SECP256K1_PARAM_SIZE_BYTES 32
 
@@ -103,22 +107,131 @@ static ECDSA_Handle ecdsaHandle;
 
 const ECCParams_CurveParams* p_curve;
 
+/* Operation the PKA is working on. The driver runs one at a time. */
+static ecdsa_cc26x2_op_t* volatile g_pending;
+
+/* Driver completion callback, called from interrupt context. */
+static void cc26x2_callback(
+    ECDSA_Handle handle,
+    int_fast16_t returnStatus,
+    ECDSA_Operation operation,
+    ECDSA_OperationType operationType)
+{
+    ecdsa_cc26x2_op_t* op = g_pending;
+
+    g_pending = NULL;
+    if (!op) {
+        return;
+    }
+    if (operationType == ECDSA_OPERATION_TYPE_SIGN) {
+        if (!op->keep_key) {
+            memset(op->key_material, 0, sizeof(op->key_material));
+        }
+        memset(op->pmsn_material, 0, sizeof(op->pmsn_material));
+    }
+    op->status = (returnStatus == ECDSA_STATUS_SUCCESS) ? 0 : -1;
+    if (op->owner) {
+        process_poll(op->owner);
+    }
+}
+
+static int cc26x2_open(void)
+{
+    ECDSA_Params params;
+
+    if (!ecdsaHandle) {
+        ECDSA_init();
+        // Callback mode: the CPU is free while the PKA works.
+        ECDSA_Params_init(&params);
+        params.returnBehavior = ECDSA_RETURN_BEHAVIOR_CALLBACK;
+        params.callbackFxn = cc26x2_callback;
+        ecdsaHandle = ECDSA_open(0, &params);
+    }
+    return ecdsaHandle ? 0 : -1;
+}
+
+/* Hand a prepared operation to the driver. */
+static int cc26x2_start(ecdsa_cc26x2_op_t* op, ECDSA_OperationType type)
+{
+    int_fast16_t result;
+
+    if (!ecdsaHandle || g_pending) {
+        return -1;
+    }
+
+    op->status = ECDSA_CC26X2_PENDING;
+    g_pending = op;
+    if (type == ECDSA_OPERATION_TYPE_SIGN) {
+        result = ECDSA_sign(ecdsaHandle, &op->op.sign);
+    }
+    else {
+        result = ECDSA_verify(ecdsaHandle, &op->op.verify);
+    }
+
+    if (result != ECDSA_STATUS_SUCCESS) {
+        g_pending = NULL;
+        op->status = -1;
+        return -1;
+    }
+    return 0;
+}
+
+/* Abandon an operation. Once this returns the driver no longer refers to
+   op, so it may be wiped or go out of scope. */
+static void cc26x2_cancel(ecdsa_cc26x2_op_t* op)
+{
+    if (g_pending == op) {
+        // In callback mode the driver calls back with the cancel status.
+        ECDSA_cancelOperation(ecdsaHandle);
+        g_pending = NULL;
+    }
+    if (op->status == ECDSA_CC26X2_PENDING) {
+        op->status = -1;
+    }
+    if (!op->keep_key) {
+        memset(op->key_material, 0, sizeof(op->key_material));
+    }
+    memset(op->pmsn_material, 0, sizeof(op->pmsn_material));
+}
+
+/* Busy-wait for an operation started without an owner process. If the
+   callback has not come within ECDSA_CC26X2_TIMEOUT the operation is
+   cancelled and fails. */
+static int cc26x2_wait(ecdsa_cc26x2_op_t* op)
+{
+    clock_time_t start = clock_time();
+
+    while (op->status == ECDSA_CC26X2_PENDING) {
+        if ((clock_time_t)(clock_time() - start) > ECDSA_CC26X2_TIMEOUT) {
+            printf("ECDSA operation timed out!\n");
+            cc26x2_cancel(op);
+            break;
+        }
+        watchdog_periodic();
+    }
+    return op->status;
+}
+
 void ecdsa_cc26x2_init(ECDSA_CC26X2_CURVE curve)
 {
-    ECDSA_init();
-    // Since we are using default ECDSA_Params, we just pass in NULL for that parameter.
-    ecdsaHandle = ECDSA_open(0, NULL);
+    cc26x2_open();
+    ecdsa_cc26x2_set_curve(curve);
+}
 
+static const ECCParams_CurveParams* cc26x2_curve_params(ECDSA_CC26X2_CURVE curve)
+{
     switch (curve) {
     default:
     case ECDSA_CC26X2_CURVE_SECP256K1:
-        p_curve = &ECCParams_SECP256K1;
-        break;
+        return &ECCParams_SECP256K1;
     case ECDSA_CC26X2_CURVE_NISTP256:
-        p_curve = &ECCParams_NISTP256;
-        break;
+        return &ECCParams_NISTP256;
     }
+}
 
+void ecdsa_cc26x2_set_curve(ECDSA_CC26X2_CURVE curve)
+{
+    p_curve = cc26x2_curve_params(curve);
 }
 
 
@@ -128,82 +241,429 @@ int ecdsa_cc26x2_hash(
     uint32_t len,
     uint8_t hash[32])
 {
+    sha256(message, len, hash);
     return 0;
 }
 
-/* Compute the ECDSA signature using the secp256k1 curve. */
-int ecdsa_cc26x2_sign(
+/* Point a sign operation at its own key, nonce and result buffers. */
+static void cc26x2_bind_sign(ecdsa_cc26x2_op_t* op, const ECCParams_CurveParams* curve)
+{
+    CryptoKeyPlaintext_initKey(&op->key, op->key_material, 32);
+    CryptoKeyPlaintext_initKey(&op->pmsn, op->pmsn_material, 32);
+
+    ECDSA_OperationSign_init(&op->op.sign);
+    op->op.sign.curve = curve;
+    op->op.sign.myPrivateKey = &op->key;
+    op->op.sign.pmsn = &op->pmsn;
+    op->op.sign.hash = op->hash;
+    op->op.sign.r = op->r;
+    op->op.sign.s = op->s;
+    op->keep_key = 0;
+}
+
+/* Point a verify operation at its own key, hash and signature buffers. */
+static void cc26x2_bind_verify(ecdsa_cc26x2_op_t* op, const ECCParams_CurveParams* curve)
+{
+    CryptoKeyPlaintext_initKey(&op->key, op->key_material, 64);
+
+    ECDSA_OperationVerify_init(&op->op.verify);
+    op->op.verify.curve = curve;
+    op->op.verify.theirPublicKey = &op->key;
+    op->op.verify.hash = op->hash;
+    op->op.verify.r = op->r;
+    op->op.verify.s = op->s;
+    op->keep_key = 0;
+}
+
+/* Start computing the ECDSA signature in the background. */
+int ecdsa_cc26x2_sign_async(
+    ecdsa_cc26x2_op_t* op,
     const uint8_t priv_key[32],
     const uint8_t k[32],
     const uint8_t hash[32],
-    uint8_t r[32],
-    uint8_t s[32])
+    struct process* owner)
 {
+    if (!ecdsaHandle) {
+        printf("ECDSA not initialized!");
+        return -1;
+    }
 
-    CryptoKey myPrivateKey;
-    CryptoKey pmsnKey;
-    int_fast16_t operationResult;
-    ECDSA_OperationSign operationSign;
+    // The operands are copied so the caller's buffers may go away.
+    memcpy(op->key_material, priv_key, 32);
+    memcpy(op->pmsn_material, k, 32);
+    memcpy(op->hash, hash, 32);
+    cc26x2_bind_sign(op, p_curve);
+    op->owner = owner;
 
+    if (cc26x2_start(op, ECDSA_OPERATION_TYPE_SIGN) != 0) {
+        memset(op->key_material, 0, sizeof(op->key_material));
+        memset(op->pmsn_material, 0, sizeof(op->pmsn_material));
+        return -1;
+    }
+    return 0;
+}
+
+/* Start verifying the ECDSA signature in the background. */
+int ecdsa_cc26x2_verify_async(
+    ecdsa_cc26x2_op_t* op,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const uint8_t r[32],
+    const uint8_t s[32],
+    struct process* owner)
+{
     if (!ecdsaHandle) {
         printf("ECDSA not initialized!");
         return -1;
     }
 
-    // Initialize myPrivateKey
-    CryptoKeyPlaintext_initKey(&myPrivateKey, (uint8_t*)priv_key, 32);
-    CryptoKeyPlaintext_initKey(&pmsnKey, (uint8_t*)k, 32);
+    memcpy(op->key_material, pub_key, 64);
+    memcpy(op->hash, hash, 32);
+    memcpy(op->r, r, 32);
+    memcpy(op->s, s, 32);
+    cc26x2_bind_verify(op, p_curve);
+    op->owner = owner;
 
-    // Initialize the operation
-    ECDSA_OperationSign_init(&operationSign);
-    operationSign.curve = p_curve;
-    operationSign.myPrivateKey = &myPrivateKey;
-    operationSign.pmsn = &pmsnKey;
-    operationSign.hash = hash;
-    operationSign.r = r;
-    operationSign.s = s;
+    return cc26x2_start(op, ECDSA_OPERATION_TYPE_VERIFY);
+}
 
-    // Generate the signature
-    operationResult = ECDSA_sign(ecdsaHandle, &operationSign);
+int ecdsa_cc26x2_result(ecdsa_cc26x2_op_t* op)
+{
+    return op->status;
+}
 
-    return operationResult;
+/* Compute the ECDSA signature using the selected curve. */
+int ecdsa_cc26x2_sign(
+    const uint8_t priv_key[32],
+    const uint8_t k[32],
+    const uint8_t hash[32],
+    uint8_t r[32],
+    uint8_t s[32])
+{
+    ecdsa_cc26x2_op_t op;
+
+    if (ecdsa_cc26x2_sign_async(&op, priv_key, k, hash, NULL) != 0 ||
+        cc26x2_wait(&op) != 0) {
+        return -1;
+    }
+    memcpy(r, op.r, 32);
+    memcpy(s, op.s, 32);
+    return 0;
 }
 
-/* Verify the ECDSA signature using the secp256k1 curve. */
+/* Verify the ECDSA signature using the selected curve. */
 int ecdsa_cc26x2_verify(
     const uint8_t pub_key[64],
     const uint8_t hash[32],
     uint8_t r[32],
     uint8_t s[32])
 {
-    CryptoKey theirPublicKey;
-    int_fast16_t operationResult;
-    ECDSA_OperationVerify operationVerify;
+    ecdsa_cc26x2_op_t op;
 
-    if (!ecdsaHandle) {
-        printf("ECDSA not initialized!");
+    if (ecdsa_cc26x2_verify_async(&op, pub_key, hash, r, s, NULL) != 0) {
+        return -1;
+    }
+    return cc26x2_wait(&op);
+}
+
+/* Sessions: the operation objects are bound once and only the operands
+   change from call to call. */
+
+static void cc26x2_account(ecdsa_cc26x2_timing_t* t, uint64_t setup, uint64_t compute)
+{
+    t->count++;
+    t->last_setup = setup;
+    t->last_compute = compute;
+    t->total_setup += setup;
+    t->total_compute += compute;
+}
+
+int ecdsa_cc26x2_session_open(ecdsa_cc26x2_session_t* session, ECDSA_CC26X2_CURVE curve)
+{
+    memset(session, 0, sizeof(*session));
+    if (cc26x2_open() != 0) {
+        return -1;
+    }
+    perf_init();
+
+    session->curve = cc26x2_curve_params(curve);
+    cc26x2_bind_sign(&session->sign, session->curve);
+    cc26x2_bind_verify(&session->verify, session->curve);
+    session->sign.keep_key = 1;
+    return 0;
+}
+
+int ecdsa_cc26x2_session_set_key(ecdsa_cc26x2_session_t* session, const uint8_t priv_key[32])
+{
+    if (g_pending == &session->sign) {
+        return -1;
+    }
+    memcpy(session->sign.key_material, priv_key, 32);
+    session->has_key = 1;
+    return 0;
+}
+
+int ecdsa_cc26x2_session_sign(
+    ecdsa_cc26x2_session_t* session,
+    const uint8_t k[32],
+    const uint8_t hash[32],
+    uint8_t r[32],
+    uint8_t s[32])
+{
+    ecdsa_cc26x2_op_t* op = &session->sign;
+    uint64_t start;
+    uint64_t setup;
+    int result;
+
+    if (!session->has_key) {
+        return -1;
+    }
+
+    start = perf_cycles();
+    memcpy(op->pmsn_material, k, 32);
+    memcpy(op->hash, hash, 32);
+    op->owner = NULL;
+    if (cc26x2_start(op, ECDSA_OPERATION_TYPE_SIGN) != 0) {
+        memset(op->pmsn_material, 0, sizeof(op->pmsn_material));
+        return -1;
+    }
+    setup = perf_cycles() - start;
+
+    start = perf_cycles();
+    result = cc26x2_wait(op);
+    cc26x2_account(&session->sign_timing, setup, perf_cycles() - start);
+
+    if (result == 0) {
+        memcpy(r, op->r, 32);
+        memcpy(s, op->s, 32);
+    }
+    return result;
+}
+
+int ecdsa_cc26x2_session_verify(
+    ecdsa_cc26x2_session_t* session,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const uint8_t r[32],
+    const uint8_t s[32])
+{
+    ecdsa_cc26x2_op_t* op = &session->verify;
+    uint64_t start;
+    uint64_t setup;
+    int result;
+
+    start = perf_cycles();
+    memcpy(op->key_material, pub_key, 64);
+    memcpy(op->hash, hash, 32);
+    memcpy(op->r, r, 32);
+    memcpy(op->s, s, 32);
+    op->owner = NULL;
+    if (cc26x2_start(op, ECDSA_OPERATION_TYPE_VERIFY) != 0) {
         return -1;
     }
+    setup = perf_cycles() - start;
+
+    start = perf_cycles();
+    result = cc26x2_wait(op);
+    cc26x2_account(&session->verify_timing, setup, perf_cycles() - start);
+    return result;
+}
+
+void ecdsa_cc26x2_session_close(ecdsa_cc26x2_session_t* session)
+{
+    if (g_pending == &session->sign || g_pending == &session->verify) {
+        cc26x2_wait((ecdsa_cc26x2_op_t*)g_pending);
+    }
+    memset(session, 0, sizeof(*session));
+}
+
+/* Engine backend. The PKA driver takes its integers little-endian while the
+   engine passes them big-endian, so every operand is byte-reversed here. */
+
+static void reverse32(uint8_t dst[32], const uint8_t src[32])
+{
+    int i;
+    for (i = 0; i < 32; i++) {
+        dst[i] = src[31 - i];
+    }
+}
+
+static int cc26x2_backend_init(void)
+{
+    return cc26x2_open();
+}
+
+static int cc26x2_backend_set_curve(ecdsa_curve_t curve)
+{
+    ecdsa_cc26x2_set_curve((curve == ECDSA_CURVE_SECP256R1) ?
+        ECDSA_CC26X2_CURVE_NISTP256 : ECDSA_CC26X2_CURVE_SECP256K1);
+    return 0;
+}
+
+static int cc26x2_backend_sign(
+    const uint8_t priv_key[32],
+    const uint8_t k[32],
+    const uint8_t hash[32],
+    uint8_t r[32],
+    uint8_t s[32])
+{
+    uint8_t le_priv[32];
+    uint8_t le_k[32];
+    uint8_t le_hash[32];
+    uint8_t le_r[32];
+    uint8_t le_s[32];
+    int result;
+
+    reverse32(le_priv, priv_key);
+    reverse32(le_k, k);
+    reverse32(le_hash, hash);
+    result = ecdsa_cc26x2_sign(le_priv, le_k, le_hash, le_r, le_s);
+    memset(le_priv, 0, sizeof(le_priv));
+    memset(le_k, 0, sizeof(le_k));
+
+    reverse32(r, le_r);
+    reverse32(s, le_s);
+    return (result == 0) ? 0 : -1;
+}
+
+static int cc26x2_backend_verify(
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    uint8_t r[32],
+    uint8_t s[32])
+{
+    uint8_t le_pub[64];
+    uint8_t le_hash[32];
+    uint8_t le_r[32];
+    uint8_t le_s[32];
+
+    reverse32(le_pub, pub_key);
+    reverse32(le_pub + 32, pub_key + 32);
+    reverse32(le_hash, hash);
+    reverse32(le_r, r);
+    reverse32(le_s, s);
+    return (ecdsa_cc26x2_verify(le_pub, le_hash, le_r, le_s) == 0) ? 0 : -1;
+}
+
+/* Resumable operations: begin starts the PKA, step reports whether it has
+   finished. The operation lives in the engine's context; the process that
+   began it is polled on completion. */
+
+typedef char cc26x2_op_fits[(sizeof(ecdsa_cc26x2_op_t) <= ECDSA_STEP_CTX_SIZE) ? 1 : -1];
+
+static int cc26x2_backend_sign_begin(
+    void* ctx,
+    const uint8_t priv_key[32],
+    const uint8_t k[32],
+    const uint8_t hash[32])
+{
+    uint8_t le_priv[32];
+    uint8_t le_k[32];
+    uint8_t le_hash[32];
+    int result;
+
+    reverse32(le_priv, priv_key);
+    reverse32(le_k, k);
+    reverse32(le_hash, hash);
+    result = ecdsa_cc26x2_sign_async((ecdsa_cc26x2_op_t*)ctx, le_priv, le_k, le_hash,
+        PROCESS_CURRENT());
+    memset(le_priv, 0, sizeof(le_priv));
+    memset(le_k, 0, sizeof(le_k));
+    return result;
+}
+
+static int cc26x2_backend_sign_step(
+    void* ctx,
+    unsigned iterations,
+    uint8_t r[32],
+    uint8_t s[32])
+{
+    ecdsa_cc26x2_op_t* op = (ecdsa_cc26x2_op_t*)ctx;
+
+    if (op->status == ECDSA_CC26X2_PENDING) {
+        return ECDSA_STEP_AGAIN;
+    }
+    if (op->status == 0) {
+        reverse32(r, op->r);
+        reverse32(s, op->s);
+    }
+    return op->status;
+}
 
-    // Initialize theirPublicKey
-    CryptoKeyPlaintext_initKey(&theirPublicKey, (uint8_t*)pub_key, 64);
+static int cc26x2_backend_verify_begin(
+    void* ctx,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const uint8_t r[32],
+    const uint8_t s[32])
+{
+    uint8_t le_pub[64];
+    uint8_t le_hash[32];
+    uint8_t le_r[32];
+    uint8_t le_s[32];
+
+    reverse32(le_pub, pub_key);
+    reverse32(le_pub + 32, pub_key + 32);
+    reverse32(le_hash, hash);
+    reverse32(le_r, r);
+    reverse32(le_s, s);
+    return ecdsa_cc26x2_verify_async((ecdsa_cc26x2_op_t*)ctx, le_pub, le_hash, le_r, le_s,
+        PROCESS_CURRENT());
+}
 
-    ECDSA_OperationVerify_init(&operationVerify);
-    operationVerify.curve = p_curve;
-    operationVerify.theirPublicKey = &theirPublicKey;
-    operationVerify.hash = hash;
-    operationVerify.r = r;
-    operationVerify.s = s;
+static int cc26x2_backend_verify_step(
+    void* ctx,
+    unsigned iterations)
+{
+    ecdsa_cc26x2_op_t* op = (ecdsa_cc26x2_op_t*)ctx;
 
-    // Verify the signature
-    operationResult = ECDSA_verify(ecdsaHandle, &operationVerify);
+    return (op->status == ECDSA_CC26X2_PENDING) ? ECDSA_STEP_AGAIN : op->status;
+}
 
-    return operationResult;
+static void cc26x2_backend_cancel(void* ctx)
+{
+    cc26x2_cancel((ecdsa_cc26x2_op_t*)ctx);
 }
 
+const ecdsa_engine_backend_t ecdsa_cc26x2_backend = {
+    .name = "cc26x2-pka",
+    .caps = ECDSA_CAP_SECP256K1 | ECDSA_CAP_SECP256R1 | ECDSA_CAP_ASYNC,
+    .init = cc26x2_backend_init,
+    .set_curve = cc26x2_backend_set_curve,
+    .random = NULL,
+    .hash = ecdsa_cc26x2_hash,
+    .get_pubkey = NULL,
+    .sign = cc26x2_backend_sign,
+    .verify = cc26x2_backend_verify,
+    .sign_batch = NULL,
+    .recover = NULL,
+    .sign_begin = cc26x2_backend_sign_begin,
+    .sign_step = cc26x2_backend_sign_step,
+    .verify_begin = cc26x2_backend_verify_begin,
+    .verify_step = cc26x2_backend_verify_step,
+    .cancel = cc26x2_backend_cancel,
+};
+
 //66d59cd0e3e8877be123612ce5112cd24957db5c02c01c20ff554eb2c9eab8af1d0b6aa5f589e23deea2e459085456136f001cd2aec0111acf61e11ee8ecb419
 //0000200000013bbb0000000020003fa40000000000000002e4093df8432a8be5
 
+/* Session shared by the test functions, opened on first use. The vectors
+   are for NIST P-256. */
+static ecdsa_cc26x2_session_t test_session;
+static uint8_t test_session_open;
+
+static ecdsa_cc26x2_session_t* test_get_session(void)
+{
+    if (!test_session_open) {
+        if (ecdsa_cc26x2_session_open(&test_session, ECDSA_CC26X2_CURVE_NISTP256) != 0) {
+            printf("ECDSA_open FAILED!");
+            return NULL;
+        }
+        test_session_open = 1;
+    }
+    return &test_session;
+}
+
 void ecdsa_cc26x2_test_sign()
 {
     printf("test sign...\n");
@@ -230,52 +690,26 @@ void ecdsa_cc26x2_test_sign()
     uint8_t r[32] = { 0 };
     uint8_t s[32] = { 0 };
 
+    ecdsa_cc26x2_session_t* session = test_get_session();
+    const ecdsa_cc26x2_timing_t* t;
 
-    CryptoKey myPrivateKey;
-    CryptoKey pmsnKey;
-
-
-
-    int_fast16_t operationResult;
-
-    ECDSA_OperationSign operationSign;
-
-    int start = clock_time();
-
-    if (!ecdsaHandle) {
-        printf("ECDSA_open FAILED!");
+    if (!session) {
         return;
     }
 
-    // Initialize myPrivateKey
-    CryptoKeyPlaintext_initKey(&myPrivateKey, myPrivateKeyingMaterial, sizeof(myPrivateKeyingMaterial));
-    CryptoKeyPlaintext_initKey(&pmsnKey, pmsn, sizeof(pmsn));
-
-    // Initialize the operation
-    ECDSA_OperationSign_init(&operationSign);
-    operationSign.curve = p_curve;
-    operationSign.myPrivateKey = &myPrivateKey;
-    operationSign.pmsn = &pmsnKey;
-    operationSign.hash = messageHashSHA256;
-    operationSign.r = r;
-    operationSign.s = s;
-
-    int inittime = clock_time() - start;
+    ecdsa_cc26x2_session_set_key(session, myPrivateKeyingMaterial);
 
-    start = clock_time();
     // Generate the signature
-    operationResult = ECDSA_sign(ecdsaHandle, &operationSign);
-    int signtime = clock_time() - start;
-    if (operationResult != ECDSA_STATUS_SUCCESS) {
+    if (ecdsa_cc26x2_session_sign(session, pmsn, messageHashSHA256, r, s) != 0) {
         printf("ECDSA_sign FAILED!\n");
     }
     else {
-        printf("ECDSA_sign SUCCESS! init=%d sign=%d\n",
-            (inittime * 1000) / CLOCK_SECOND,
-            (signtime * 1000) / CLOCK_SECOND);
+        t = &session->sign_timing;
+        printf("ECDSA_sign SUCCESS! init=%lu cycles (%lu ns) sign=%lu cycles (%lu ns)\n",
+            (unsigned long)t->last_setup, (unsigned long)perf_cycles_to_ns(t->last_setup),
+            (unsigned long)t->last_compute, (unsigned long)perf_cycles_to_ns(t->last_compute));
     }
 
-    ECDSA_close(ecdsaHandle);
     // Send out signature
     // r should be   0x4F, 0x10, 0x46, 0xCA, 0x9A, 0xB6, 0x25, 0x73,
     //               0xF5, 0x3E, 0x0B, 0x1F, 0x6F, 0x31, 0x4C, 0xE4,
@@ -325,52 +759,22 @@ void ecdsa_cc26x2_test_verify()
         0xCD, 0x92, 0x63, 0x2D, 0x12, 0xC2, 0x42, 0xDC };
 
 
-    CryptoKey theirPublicKey;
+    ecdsa_cc26x2_session_t* session = test_get_session();
+    const ecdsa_cc26x2_timing_t* t;
 
-    ECDSA_Handle ecdsaHandle;
-
-    int_fast16_t operationResult;
-
-    ECDSA_OperationVerify operationVerify;
-
-    int start = clock_time();
-
-    // Since we are using default ECDSA_Params, we just pass in NULL for that parameter.
-    ecdsaHandle = ECDSA_open(0, NULL);
-
-    if (!ecdsaHandle) {
-        printf("ECDSA_open FAILED!");
+    if (!session) {
         return;
     }
 
-    // Initialize theirPublicKey
-    CryptoKeyPlaintext_initKey(&theirPublicKey, theirPublicKeyingMaterial, sizeof(theirPublicKeyingMaterial));
-
-    ECDSA_OperationVerify_init(&operationVerify);
-    operationVerify.curve = p_curve;
-    operationVerify.theirPublicKey = &theirPublicKey;
-    operationVerify.hash = messageHashSHA256;
-    operationVerify.r = r;
-    operationVerify.s = s;
-
-    int inittime = clock_time() - start;
-
-    start = clock_time();
-
-    // Generate the keying material for myPublicKey and store it in myPublicKeyingMaterial
-    operationResult = ECDSA_verify(ecdsaHandle, &operationVerify);
-    int verifytime = clock_time() - start;
-
-    if (operationResult != ECDSA_STATUS_SUCCESS) {
+    if (ecdsa_cc26x2_session_verify(session, theirPublicKeyingMaterial, messageHashSHA256, r, s) != 0) {
         printf("ECDSA_verify FAILED!\n");
     }
     else {
-        printf("ECDSA_verify SUCCESS! init=%d sign=%d\n",
-            (inittime * 1000) / CLOCK_SECOND,
-            (verifytime * 1000) / CLOCK_SECOND);
+        t = &session->verify_timing;
+        printf("ECDSA_verify SUCCESS! init=%lu cycles (%lu ns) verify=%lu cycles (%lu ns)\n",
+            (unsigned long)t->last_setup, (unsigned long)perf_cycles_to_ns(t->last_setup),
+            (unsigned long)t->last_compute, (unsigned long)perf_cycles_to_ns(t->last_compute));
     }
-
-    ECDSA_close(ecdsaHandle);
 }
 
 
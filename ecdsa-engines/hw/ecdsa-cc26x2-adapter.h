@@ -35,15 +35,34 @@
 #ifndef __ECDSA_TICC26X2_ADAPTER_H
 #define __ECDSA_TICC26X2_ADAPTER_H
 
+#include "contiki.h"
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
+#include <ti/drivers/ECDSA.h>
+
+/* Result of an operation the PKA is still working on. */
+#define ECDSA_CC26X2_PENDING 1
+
+/* ECDSA_CC26X2_TIMEOUT - Clock ticks the synchronous calls wait for the PKA
+   before cancelling the operation. A signature takes about 32 ms and a
+   verification about 66 ms. Override with ECDSA_CC26X2_CONF_TIMEOUT. */
+#ifdef ECDSA_CC26X2_CONF_TIMEOUT
+#define ECDSA_CC26X2_TIMEOUT ECDSA_CC26X2_CONF_TIMEOUT
+#else
+#define ECDSA_CC26X2_TIMEOUT CLOCK_SECOND
+#endif
+
 typedef enum
 {
     ECDSA_CC26X2_CURVE_SECP256K1,
     ECDSA_CC26X2_CURVE_NISTP256,
 } ECDSA_CC26X2_CURVE;
 
-/* */
+/* Open the PKA driver and select the curve. */
 void ecdsa_cc26x2_init(ECDSA_CC26X2_CURVE curve);
 
+/* Select the curve for subsequent operations. */
+void ecdsa_cc26x2_set_curve(ECDSA_CC26X2_CURVE curve);
+
 /* Get the SHA-256 hash of the message. */
 int ecdsa_cc26x2_hash(
     const uint8_t* message,
@@ -65,6 +84,103 @@ int ecdsa_cc26x2_verify(
     uint8_t r[32],
     uint8_t s[32]);
 
+/* One PKA operation. The driver reads its operands from here and writes the
+   signature back here, so it must stay in place until the result is known.
+   All operands are little-endian. */
+typedef struct
+{
+    union {
+        ECDSA_OperationSign sign;
+        ECDSA_OperationVerify verify;
+    } op;
+    CryptoKey key;
+    CryptoKey pmsn;
+    uint8_t key_material[64];
+    uint8_t pmsn_material[32];
+    uint8_t hash[32];
+    uint8_t r[32];
+    uint8_t s[32];
+    struct process* owner;
+    volatile int status;
+    uint8_t keep_key;       /* leave key_material in place after signing */
+} ecdsa_cc26x2_op_t;
+
+/* Start a signature and return without waiting for it. The driver runs one
+   operation at a time; -1 is returned if another is still in progress.
+   On completion the private key and k are wiped from the operation and the
+   owner process, if any, is polled. */
+int ecdsa_cc26x2_sign_async(
+    ecdsa_cc26x2_op_t* op,
+    const uint8_t priv_key[32],
+    const uint8_t k[32],
+    const uint8_t hash[32],
+    struct process* owner);
+
+/* Start a verification and return without waiting for it. */
+int ecdsa_cc26x2_verify_async(
+    ecdsa_cc26x2_op_t* op,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const uint8_t r[32],
+    const uint8_t s[32],
+    struct process* owner);
+
+/* ECDSA_CC26X2_PENDING while the PKA is busy, then 0 on success or -1.
+   A finished signature is in op->r and op->s. */
+int ecdsa_cc26x2_result(ecdsa_cc26x2_op_t* op);
+
+/* Time spent per operation, in perf_cycles() units. Setup is the work done
+   before the PKA is started; compute runs from there to the result. */
+typedef struct
+{
+    uint32_t count;
+    uint64_t last_setup;
+    uint64_t last_compute;
+    uint64_t total_setup;
+    uint64_t total_compute;
+} ecdsa_cc26x2_timing_t;
+
+/* A run of operations on one curve, and for signing one private key. The
+   curve parameters, key object and operation structures are prepared once
+   when the session opens, so each call only copies in its operands before
+   starting the PKA. The private key stays in the session until it is
+   replaced or the session is closed. */
+typedef struct
+{
+    const ECCParams_CurveParams* curve;
+    ecdsa_cc26x2_op_t sign;
+    ecdsa_cc26x2_op_t verify;
+    uint8_t has_key;
+    ecdsa_cc26x2_timing_t sign_timing;
+    ecdsa_cc26x2_timing_t verify_timing;
+} ecdsa_cc26x2_session_t;
+
+/* Open the PKA driver if needed and prepare the session for the curve. */
+int ecdsa_cc26x2_session_open(ecdsa_cc26x2_session_t* session, ECDSA_CC26X2_CURVE curve);
+
+/* Load the private key used by ecdsa_cc26x2_session_sign(). */
+int ecdsa_cc26x2_session_set_key(ecdsa_cc26x2_session_t* session, const uint8_t priv_key[32]);
+
+/* Sign with the session key and wait for the result. Operands are
+   little-endian, as for ecdsa_cc26x2_sign(). */
+int ecdsa_cc26x2_session_sign(
+    ecdsa_cc26x2_session_t* session,
+    const uint8_t k[32],
+    const uint8_t hash[32],
+    uint8_t r[32],
+    uint8_t s[32]);
+
+/* Verify on the session curve and wait for the result. */
+int ecdsa_cc26x2_session_verify(
+    ecdsa_cc26x2_session_t* session,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const uint8_t r[32],
+    const uint8_t s[32]);
+
+/* Wipe the session key. The driver stays open for other users. */
+void ecdsa_cc26x2_session_close(ecdsa_cc26x2_session_t* session);
+
 void ecdsa_cc26x2_test_sign();
 void ecdsa_cc26x2_test_verify();
 
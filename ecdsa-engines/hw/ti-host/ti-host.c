@@ -0,0 +1,592 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Linux stand-in for the TI ECDSA driver, ECCParams and CryptoKeyPlaintext.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <ti/devices/DeviceFamily.h>
+#include DeviceFamily_constructPath(driverlib/pka.h)
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
+#include <ti/drivers/cryptoutils/ecc/ECCParams.h>
+#include <ti/drivers/ECDSA.h>
+#include "ti-host.h"
+#include "ecdsa-engines/sw/uecc.h"
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#define PARAM_SIZE 32
+
+/* NIST P-256 in little endian format, as the PKA takes it. */
+const PKA_EccPoint256 NISTP256_generator = {
+    .x = { .byte = { 0x96, 0xC2, 0x98, 0xD8, 0x45, 0x39, 0xA1, 0xF4,
+    0xA0, 0x33, 0xEB, 0x2D, 0x81, 0x7D, 0x03, 0x77,
+    0xF2, 0x40, 0xA4, 0x63, 0xE5, 0xE6, 0xBC, 0xF8,
+    0x47, 0x42, 0x2C, 0xE1, 0xF2, 0xD1, 0x17, 0x6B } },
+    .y = { .byte = { 0xF5, 0x51, 0xBF, 0x37, 0x68, 0x40, 0xB6, 0xCB,
+    0xCE, 0x5E, 0x31, 0x6B, 0x57, 0x33, 0xCE, 0x2B,
+    0x16, 0x9E, 0x0F, 0x7C, 0x4A, 0xEB, 0xE7, 0x8E,
+    0x9B, 0x7F, 0x1A, 0xFE, 0xE2, 0x42, 0xE3, 0x4F } },
+};
+
+const PKA_EccParam256 NISTP256_prime = {
+    .byte = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF } };
+
+const PKA_EccParam256 NISTP256_a = {
+    .byte = { 0xFC, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF } };
+
+const PKA_EccParam256 NISTP256_b = {
+    .byte = { 0x4B, 0x60, 0xD2, 0x27, 0x3E, 0x3C, 0xCE, 0x3B,
+    0xF6, 0xB0, 0x53, 0xCC, 0xB0, 0x06, 0x1D, 0x65,
+    0xBC, 0x86, 0x98, 0x76, 0x55, 0xBD, 0xEB, 0xB3,
+    0xE7, 0x93, 0x3A, 0xAA, 0xD8, 0x35, 0xC6, 0x5A } };
+
+const PKA_EccParam256 NISTP256_order = {
+    .byte = { 0x51, 0x25, 0x63, 0xFC, 0xC2, 0xCA, 0xB9, 0xF3,
+    0x84, 0x9E, 0x17, 0xA7, 0xAD, 0xFA, 0xE6, 0xBC,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF } };
+
+const ECCParams_CurveParams ECCParams_NISTP256 = {
+    .curveType = ECCParams_CURVE_TYPE_SHORT_WEIERSTRASS,
+    .length = PARAM_SIZE,
+    .prime = NISTP256_prime.byte,
+    .order = NISTP256_order.byte,
+    .a = NISTP256_a.byte,
+    .b = NISTP256_b.byte,
+    .generatorX = NISTP256_generator.x.byte,
+    .generatorY = NISTP256_generator.y.byte
+};
+
+/* The secp256k1 parameters are supplied by the CC26x2 adapter; the curve is
+   recognized by its prime. */
+static const uint8_t secp256k1_prime[PARAM_SIZE] = {
+    0x2F, 0xFC, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+int_fast16_t ECCParams_getUncompressedGeneratorPoint(
+    const ECCParams_CurveParams* curveParams,
+    uint8_t* buffer,
+    size_t length)
+{
+    if (length != 2 * curveParams->length + 1) {
+        return ECCParams_STATUS_ERROR;
+    }
+    buffer[0] = 0x04;
+    memcpy(buffer + 1, curveParams->generatorX, curveParams->length);
+    memcpy(buffer + 1 + curveParams->length, curveParams->generatorY, curveParams->length);
+    return ECCParams_STATUS_SUCCESS;
+}
+
+int_fast16_t CryptoKeyPlaintext_initKey(CryptoKey* keyHandle, uint8_t* key, size_t keyLength)
+{
+    keyHandle->encoding = CryptoKey_PLAINTEXT;
+    keyHandle->u.plaintext.keyMaterial = key;
+    keyHandle->u.plaintext.keyLength = keyLength;
+    return CryptoKey_STATUS_SUCCESS;
+}
+
+int_fast16_t CryptoKeyPlaintext_initBlankKey(CryptoKey* keyHandle, uint8_t* keyLocation, size_t keyLength)
+{
+    keyHandle->encoding = CryptoKey_BLANK_PLAINTEXT;
+    keyHandle->u.plaintext.keyMaterial = keyLocation;
+    keyHandle->u.plaintext.keyLength = keyLength;
+    return CryptoKey_STATUS_SUCCESS;
+}
+
+/* Driver instance. One operation at a time, as with the PKA. */
+typedef struct
+{
+    uint8_t open;
+    uint8_t busy;                   /* an operation has been started and not completed */
+    uint8_t stop;                   /* worker thread is to exit */
+    uint32_t seq;                   /* counts started operations */
+    ECDSA_Params params;
+    pthread_t worker;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct timespec due;            /* modelled completion time */
+    int_fast16_t status;
+    ECDSA_OperationType type;
+    ECDSA_Operation operation;
+    uint8_t r[PARAM_SIZE];          /* result, copied out on completion */
+    uint8_t s[PARAM_SIZE];
+} ti_host_object_t;
+
+static ti_host_object_t g_object = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+static ECDSA_Config g_config[ECDSA_COUNT] = {
+    { .object = &g_object, .hwAttrs = NULL },
+};
+
+static struct
+{
+    uint32_t setup_us;
+    uint32_t sign_us;
+    uint32_t verify_us;
+} g_latency = { TI_HOST_SETUP_US, TI_HOST_SIGN_US, TI_HOST_VERIFY_US };
+
+static ti_host_stats_t g_stats;
+
+void ti_host_set_latency(
+    uint32_t setup_us,
+    uint32_t sign_us,
+    uint32_t verify_us)
+{
+    g_latency.setup_us = setup_us;
+    g_latency.sign_us = sign_us;
+    g_latency.verify_us = verify_us;
+}
+
+void ti_host_get_stats(ti_host_stats_t* stats)
+{
+    pthread_mutex_lock(&g_object.lock);
+    *stats = g_stats;
+    pthread_mutex_unlock(&g_object.lock);
+}
+
+static void due_after(struct timespec* due, uint32_t us)
+{
+    clock_gettime(CLOCK_MONOTONIC, due);
+    due->tv_sec += us / 1000000;
+    due->tv_nsec += (long)(us % 1000000) * 1000;
+    if (due->tv_nsec >= 1000000000) {
+        due->tv_sec++;
+        due->tv_nsec -= 1000000000;
+    }
+}
+
+static void sleep_until(const struct timespec* due)
+{
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, due, NULL) == EINTR) {
+    }
+}
+
+static void spin_until(const struct timespec* due)
+{
+    struct timespec now;
+
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while (now.tv_sec < due->tv_sec ||
+        (now.tv_sec == due->tv_sec && now.tv_nsec < due->tv_nsec));
+}
+
+/* The PKA takes integers little-endian, uECC big-endian. */
+static void reverse(uint8_t* dst, const uint8_t* src, uint32_t len)
+{
+    uint32_t i;
+    for (i = 0; i < len; i++) {
+        dst[i] = src[len - 1 - i];
+    }
+}
+
+/* Nonzero if little-endian a < b. */
+static int le_less(const uint8_t* a, const uint8_t* b)
+{
+    int i;
+    for (i = PARAM_SIZE - 1; i >= 0; i--) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i];
+        }
+    }
+    return 0;
+}
+
+static int le_zero(const uint8_t* a)
+{
+    int i;
+    for (i = 0; i < PARAM_SIZE; i++) {
+        if (a[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int key_ok(const CryptoKey* key, uint32_t len)
+{
+    return key && key->encoding == CryptoKey_PLAINTEXT &&
+        key->u.plaintext.keyLength == len;
+}
+
+/* Select the uECC curve matching the driver parameters. */
+static int select_curve(const ECCParams_CurveParams* curve)
+{
+    uECC_Curve l_curve = NULL;
+
+    if (curve && curve->length == PARAM_SIZE) {
+        if (memcmp(curve->prime, NISTP256_prime.byte, PARAM_SIZE) == 0) {
+            l_curve = uECC_curve_secp256r1();
+        }
+        else if (memcmp(curve->prime, secp256k1_prime, PARAM_SIZE) == 0) {
+            l_curve = uECC_curve_secp256k1();
+        }
+    }
+    return (l_curve && uECC_set_curve(l_curve)) ? 0 : -1;
+}
+
+static int_fast16_t compute_sign(
+    ECDSA_OperationSign* op,
+    uint8_t r[PARAM_SIZE],
+    uint8_t s[PARAM_SIZE])
+{
+    uint8_t priv[PARAM_SIZE];
+    uint8_t k[PARAM_SIZE];
+    uint8_t hash[PARAM_SIZE];
+    uint8_t sig[2 * PARAM_SIZE];
+    int_fast16_t status = ECDSA_STATUS_ERROR;
+
+    if (!key_ok(op->myPrivateKey, PARAM_SIZE) || !key_ok(op->pmsn, PARAM_SIZE) ||
+        !op->hash || !op->r || !op->s) {
+        return ECDSA_STATUS_ERROR;
+    }
+
+    reverse(priv, op->myPrivateKey->u.plaintext.keyMaterial, PARAM_SIZE);
+    reverse(k, op->pmsn->u.plaintext.keyMaterial, PARAM_SIZE);
+    reverse(hash, op->hash, PARAM_SIZE);
+
+    if (uECC_sign_nonce(priv, k, hash, sig)) {
+        reverse(r, sig, PARAM_SIZE);
+        reverse(s, sig + PARAM_SIZE, PARAM_SIZE);
+        status = ECDSA_STATUS_SUCCESS;
+    }
+
+    memset(priv, 0, sizeof(priv));
+    memset(k, 0, sizeof(k));
+    return status;
+}
+
+static int_fast16_t compute_verify(ECDSA_OperationVerify* op)
+{
+    const uint8_t* pub;
+    uint8_t be_pub[2 * PARAM_SIZE];
+    uint8_t hash[PARAM_SIZE];
+    uint8_t sig[2 * PARAM_SIZE];
+    uECC_Key key;
+
+    if (!key_ok(op->theirPublicKey, 2 * PARAM_SIZE) || !op->hash || !op->r || !op->s) {
+        return ECDSA_STATUS_ERROR;
+    }
+    pub = op->theirPublicKey->u.plaintext.keyMaterial;
+
+    if (!le_less(op->r, op->curve->order)) {
+        return ECDSA_STATUS_R_LARGER_THAN_ORDER;
+    }
+    if (!le_less(op->s, op->curve->order)) {
+        return ECDSA_STATUS_S_LARGER_THAN_ORDER;
+    }
+    if (!le_less(pub, op->curve->prime) || !le_less(pub + PARAM_SIZE, op->curve->prime)) {
+        return ECDSA_STATUS_PUBLIC_KEY_LARGER_THAN_PRIME;
+    }
+    if (le_zero(pub) && le_zero(pub + PARAM_SIZE)) {
+        return ECDSA_STATUS_POINT_AT_INFINITY;
+    }
+
+    reverse(be_pub, pub, PARAM_SIZE);
+    reverse(be_pub + PARAM_SIZE, pub + PARAM_SIZE, PARAM_SIZE);
+    if (!uECC_key_load(&key, be_pub, sizeof(be_pub))) {
+        return ECDSA_STATUS_PUBLIC_KEY_NOT_ON_CURVE;
+    }
+
+    reverse(hash, op->hash, PARAM_SIZE);
+    reverse(sig, op->r, PARAM_SIZE);
+    reverse(sig + PARAM_SIZE, op->s, PARAM_SIZE);
+    return uECC_verify_key(&key, hash, sig) ? ECDSA_STATUS_SUCCESS : ECDSA_STATUS_ERROR;
+}
+
+/* Stands in for the PKA interrupt: waits out the modelled latency, delivers
+   the result and calls back. */
+static void* worker(void* arg)
+{
+    ti_host_object_t* obj = (ti_host_object_t*)arg;
+    ECDSA_Operation operation;
+    ECDSA_OperationType type;
+    int_fast16_t status;
+    struct timespec due;
+    uint32_t seq;
+
+    pthread_mutex_lock(&obj->lock);
+    for (;;) {
+        while (!obj->busy && !obj->stop) {
+            pthread_cond_wait(&obj->cond, &obj->lock);
+        }
+        if (obj->stop) {
+            break;
+        }
+
+        /* Sleep until the operation is due, or is cancelled. */
+        seq = obj->seq;
+        due = obj->due;
+        while (!obj->stop && obj->busy && obj->seq == seq &&
+            pthread_cond_timedwait(&obj->cond, &obj->lock, &due) != ETIMEDOUT) {
+        }
+        if (obj->stop) {
+            break;
+        }
+        if (!obj->busy || obj->seq != seq) {
+            /* Cancelled meanwhile, and perhaps another one started. */
+            continue;
+        }
+
+        operation = obj->operation;
+        type = obj->type;
+        status = obj->status;
+        if (type == ECDSA_OPERATION_TYPE_SIGN && status == ECDSA_STATUS_SUCCESS) {
+            memcpy(operation.sign->r, obj->r, PARAM_SIZE);
+            memcpy(operation.sign->s, obj->s, PARAM_SIZE);
+        }
+        obj->busy = 0;
+
+        /* The callback may start the next operation. */
+        pthread_mutex_unlock(&obj->lock);
+        obj->params.callbackFxn((ECDSA_Handle)&g_config[0], status, operation, type);
+        pthread_mutex_lock(&obj->lock);
+    }
+    obj->busy = 0;
+    pthread_mutex_unlock(&obj->lock);
+    return NULL;
+}
+
+void ECDSA_init(void)
+{
+}
+
+void ECDSA_Params_init(ECDSA_Params* params)
+{
+    params->returnBehavior = ECDSA_RETURN_BEHAVIOR_BLOCKING;
+    params->callbackFxn = NULL;
+    params->timeout = 0;
+    params->custom = NULL;
+}
+
+ECDSA_Handle ECDSA_open(uint_least8_t index, ECDSA_Params* params)
+{
+    ti_host_object_t* obj;
+
+    if (index >= ECDSA_COUNT) {
+        return NULL;
+    }
+    obj = (ti_host_object_t*)g_config[index].object;
+    if (obj->open) {
+        return NULL;
+    }
+
+    if (params) {
+        obj->params = *params;
+    }
+    else {
+        ECDSA_Params_init(&obj->params);
+    }
+
+    if (obj->params.returnBehavior == ECDSA_RETURN_BEHAVIOR_CALLBACK) {
+        pthread_condattr_t attr;
+
+        if (!obj->params.callbackFxn) {
+            return NULL;
+        }
+        /* The worker's deadlines are on the monotonic clock. */
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_destroy(&obj->cond);
+        pthread_cond_init(&obj->cond, &attr);
+        pthread_condattr_destroy(&attr);
+        obj->stop = 0;
+        if (pthread_create(&obj->worker, NULL, worker, obj) != 0) {
+            return NULL;
+        }
+    }
+
+    obj->busy = 0;
+    obj->open = 1;
+    return &g_config[index];
+}
+
+void ECDSA_close(ECDSA_Handle handle)
+{
+    ti_host_object_t* obj = (ti_host_object_t*)handle->object;
+
+    if (!obj->open) {
+        return;
+    }
+    if (obj->params.returnBehavior == ECDSA_RETURN_BEHAVIOR_CALLBACK) {
+        /* An operation still in progress is dropped without a callback. */
+        pthread_mutex_lock(&obj->lock);
+        obj->stop = 1;
+        pthread_cond_signal(&obj->cond);
+        pthread_mutex_unlock(&obj->lock);
+        pthread_join(obj->worker, NULL);
+    }
+    obj->open = 0;
+}
+
+void ECDSA_OperationSign_init(ECDSA_OperationSign* operation)
+{
+    memset(operation, 0, sizeof(*operation));
+}
+
+void ECDSA_OperationVerify_init(ECDSA_OperationVerify* operation)
+{
+    memset(operation, 0, sizeof(*operation));
+}
+
+/* Compute the result now in the caller's thread, so uECC is never entered
+   concurrently, then complete it when the modelled PKA would. */
+static int_fast16_t start_operation(
+    ECDSA_Handle handle,
+    ECDSA_OperationType type,
+    ECDSA_Operation operation)
+{
+    ti_host_object_t* obj = (ti_host_object_t*)handle->object;
+    const ECCParams_CurveParams* curve;
+    uECC_Curve saved = uECC_get_curve();
+    struct timespec due;
+    int_fast16_t status;
+    uint8_t r[PARAM_SIZE] = { 0 };
+    uint8_t s[PARAM_SIZE] = { 0 };
+
+    pthread_mutex_lock(&obj->lock);
+    if (!obj->open || obj->busy) {
+        g_stats.busy++;
+        pthread_mutex_unlock(&obj->lock);
+        return ECDSA_STATUS_RESOURCE_UNAVAILABLE;
+    }
+    obj->busy = 1;
+    pthread_mutex_unlock(&obj->lock);
+
+    due_after(&due, g_latency.setup_us +
+        ((type == ECDSA_OPERATION_TYPE_SIGN) ? g_latency.sign_us : g_latency.verify_us));
+
+    curve = (type == ECDSA_OPERATION_TYPE_SIGN) ? operation.sign->curve : operation.verify->curve;
+    if (select_curve(curve) != 0) {
+        status = ECDSA_STATUS_ERROR;
+    }
+    else if (type == ECDSA_OPERATION_TYPE_SIGN) {
+        status = compute_sign(operation.sign, r, s);
+    }
+    else {
+        status = compute_verify(operation.verify);
+    }
+    uECC_set_curve(saved);
+
+    pthread_mutex_lock(&obj->lock);
+    if (type == ECDSA_OPERATION_TYPE_SIGN) {
+        g_stats.signs++;
+    }
+    else {
+        g_stats.verifies++;
+    }
+
+    if (obj->params.returnBehavior == ECDSA_RETURN_BEHAVIOR_CALLBACK) {
+        obj->seq++;
+        obj->type = type;
+        obj->operation = operation;
+        obj->status = status;
+        obj->due = due;
+        memcpy(obj->r, r, PARAM_SIZE);
+        memcpy(obj->s, s, PARAM_SIZE);
+        pthread_cond_signal(&obj->cond);
+        pthread_mutex_unlock(&obj->lock);
+        memset(r, 0, sizeof(r));
+        memset(s, 0, sizeof(s));
+        return ECDSA_STATUS_SUCCESS;
+    }
+    pthread_mutex_unlock(&obj->lock);
+
+    if (obj->params.returnBehavior == ECDSA_RETURN_BEHAVIOR_POLLING) {
+        spin_until(&due);
+    }
+    else {
+        sleep_until(&due);
+    }
+    if (type == ECDSA_OPERATION_TYPE_SIGN && status == ECDSA_STATUS_SUCCESS) {
+        memcpy(operation.sign->r, r, PARAM_SIZE);
+        memcpy(operation.sign->s, s, PARAM_SIZE);
+    }
+
+    pthread_mutex_lock(&obj->lock);
+    obj->busy = 0;
+    pthread_mutex_unlock(&obj->lock);
+    return status;
+}
+
+int_fast16_t ECDSA_sign(ECDSA_Handle handle, ECDSA_OperationSign* operation)
+{
+    ECDSA_Operation op;
+
+    op.sign = operation;
+    return start_operation(handle, ECDSA_OPERATION_TYPE_SIGN, op);
+}
+
+int_fast16_t ECDSA_verify(ECDSA_Handle handle, ECDSA_OperationVerify* operation)
+{
+    ECDSA_Operation op;
+
+    op.verify = operation;
+    return start_operation(handle, ECDSA_OPERATION_TYPE_VERIFY, op);
+}
+
+int_fast16_t ECDSA_cancelOperation(ECDSA_Handle handle)
+{
+    ti_host_object_t* obj = (ti_host_object_t*)handle->object;
+    ECDSA_Operation operation;
+    ECDSA_OperationType type;
+
+    pthread_mutex_lock(&obj->lock);
+    if (!obj->busy || obj->params.returnBehavior != ECDSA_RETURN_BEHAVIOR_CALLBACK) {
+        /* Blocking and polling calls have finished by the time anyone
+           could cancel them. */
+        pthread_mutex_unlock(&obj->lock);
+        return ECDSA_STATUS_SUCCESS;
+    }
+    operation = obj->operation;
+    type = obj->type;
+    obj->busy = 0;
+    memset(obj->r, 0, PARAM_SIZE);
+    memset(obj->s, 0, PARAM_SIZE);
+    pthread_cond_signal(&obj->cond);
+    pthread_mutex_unlock(&obj->lock);
+
+    obj->params.callbackFxn(handle, ECDSA_STATUS_CANCELED, operation, type);
+    return ECDSA_STATUS_SUCCESS;
+}
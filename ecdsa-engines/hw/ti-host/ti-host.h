@@ -0,0 +1,91 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Linux stand-in for the TI ECDSA driver, ECCParams and CryptoKeyPlaintext.
+*    Lets the CC26x2 adapter, its pipelining and the signing service be built
+*    and exercised on a development host. Operations are computed by the uECC
+*    software engine and complete after a modelled PKA latency.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __TI_HOST_H
+#define __TI_HOST_H
+
+#include <stdint.h>
+
+/* TI_HOST_SETUP_US - Modelled time to load the operands of one operation
+   into PKA RAM, in microseconds. Override with TI_HOST_CONF_SETUP_US. */
+#ifdef TI_HOST_CONF_SETUP_US
+#define TI_HOST_SETUP_US TI_HOST_CONF_SETUP_US
+#else
+#define TI_HOST_SETUP_US 150
+#endif
+
+/* TI_HOST_SIGN_US - Modelled PKA time of one 256-bit signature, in
+   microseconds. Override with TI_HOST_CONF_SIGN_US. */
+#ifdef TI_HOST_CONF_SIGN_US
+#define TI_HOST_SIGN_US TI_HOST_CONF_SIGN_US
+#else
+#define TI_HOST_SIGN_US 32000
+#endif
+
+/* TI_HOST_VERIFY_US - Modelled PKA time of one 256-bit verification, in
+   microseconds. Override with TI_HOST_CONF_VERIFY_US. */
+#ifdef TI_HOST_CONF_VERIFY_US
+#define TI_HOST_VERIFY_US TI_HOST_CONF_VERIFY_US
+#else
+#define TI_HOST_VERIFY_US 66000
+#endif
+
+/* Operation counts since startup. */
+typedef struct
+{
+    uint32_t signs;
+    uint32_t verifies;
+    uint32_t busy;          /* operations refused with ECDSA_STATUS_RESOURCE_UNAVAILABLE */
+} ti_host_stats_t;
+
+/**
+ *  Change the latency model at run time. An operation completes setup_us
+ *  plus sign_us or verify_us after it is started, or when the software
+ *  computation finishes if that takes longer. All zero makes operations
+ *  complete as fast as the host computes them.
+ */
+void ti_host_set_latency(
+    uint32_t setup_us,
+    uint32_t sign_us,
+    uint32_t verify_us);
+
+/**
+ *  Copy out the operation counts.
+ */
+void ti_host_get_stats(ti_host_stats_t* stats);
+
+#endif
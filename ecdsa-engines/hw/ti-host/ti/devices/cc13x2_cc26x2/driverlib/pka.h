@@ -0,0 +1,59 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Linux stand-in for the PKA driverlib types used by the ECC curve parameters.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __TI_HOST_PKA_H
+#define __TI_HOST_PKA_H
+
+#include <stdint.h>
+
+/* 256-bit curve parameter, little-endian: byte[0] is the least significant byte. */
+typedef union
+{
+    uint8_t byte[32];
+    uint32_t word[8];
+} PKA_EccParam256;
+
+typedef struct
+{
+    PKA_EccParam256 x;
+    PKA_EccParam256 y;
+} PKA_EccPoint256;
+
+extern const PKA_EccPoint256 NISTP256_generator;
+extern const PKA_EccParam256 NISTP256_prime;
+extern const PKA_EccParam256 NISTP256_a;
+extern const PKA_EccParam256 NISTP256_b;
+extern const PKA_EccParam256 NISTP256_order;
+
+#endif
@@ -0,0 +1,145 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Linux stand-in for the TI ECDSA driver. Operations are computed by the
+*    uECC software engine and complete after a modelled PKA latency, see
+*    ti-host.h.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __TI_HOST_ECDSA_H
+#define __TI_HOST_ECDSA_H
+
+#include <stdint.h>
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKey.h>
+#include <ti/drivers/cryptoutils/ecc/ECCParams.h>
+
+#define ECDSA_STATUS_SUCCESS                        (0)
+#define ECDSA_STATUS_ERROR                          (-1)
+#define ECDSA_STATUS_RESOURCE_UNAVAILABLE           (-2)
+#define ECDSA_STATUS_R_LARGER_THAN_ORDER            (-3)
+#define ECDSA_STATUS_S_LARGER_THAN_ORDER            (-4)
+#define ECDSA_STATUS_PUBLIC_KEY_NOT_ON_CURVE        (-5)
+#define ECDSA_STATUS_PUBLIC_KEY_LARGER_THAN_PRIME   (-6)
+#define ECDSA_STATUS_POINT_AT_INFINITY              (-7)
+#define ECDSA_STATUS_CANCELED                       (-8)
+
+/* Number of driver instances ECDSA_open() accepts. */
+#define ECDSA_COUNT 1
+
+typedef struct ECDSA_Config
+{
+    void* object;
+    void const* hwAttrs;
+} ECDSA_Config;
+
+typedef ECDSA_Config* ECDSA_Handle;
+
+typedef enum
+{
+    ECDSA_RETURN_BEHAVIOR_CALLBACK = 1,     /* return at once, callbackFxn reports completion */
+    ECDSA_RETURN_BEHAVIOR_BLOCKING = 2,     /* return when the operation is complete */
+    ECDSA_RETURN_BEHAVIOR_POLLING  = 4,     /* as blocking, without sleeping */
+} ECDSA_ReturnBehavior;
+
+typedef enum
+{
+    ECDSA_OPERATION_TYPE_SIGN = 1,
+    ECDSA_OPERATION_TYPE_VERIFY = 2,
+} ECDSA_OperationType;
+
+/* Integers are little-endian, curve->length bytes each. */
+typedef struct
+{
+    const ECCParams_CurveParams* curve;
+    const CryptoKey* myPrivateKey;
+    const CryptoKey* pmsn;                  /* per-message secret number k */
+    const uint8_t* hash;
+    uint8_t* r;
+    uint8_t* s;
+} ECDSA_OperationSign;
+
+typedef struct
+{
+    const ECCParams_CurveParams* curve;
+    const CryptoKey* theirPublicKey;        /* x followed by y */
+    const uint8_t* hash;
+    const uint8_t* r;
+    const uint8_t* s;
+} ECDSA_OperationVerify;
+
+typedef union
+{
+    ECDSA_OperationSign* sign;
+    ECDSA_OperationVerify* verify;
+} ECDSA_Operation;
+
+/* Called on completion in callback mode. On the target this runs in
+   interrupt context; the stand-in calls it from its own thread. */
+typedef void (*ECDSA_CallbackFxn)(
+    ECDSA_Handle handle,
+    int_fast16_t returnStatus,
+    ECDSA_Operation operation,
+    ECDSA_OperationType operationType);
+
+typedef struct
+{
+    ECDSA_ReturnBehavior returnBehavior;
+    ECDSA_CallbackFxn callbackFxn;
+    uint32_t timeout;
+    void* custom;
+} ECDSA_Params;
+
+void ECDSA_init(void);
+
+/* Blocking mode, no callback, no timeout. */
+void ECDSA_Params_init(ECDSA_Params* params);
+
+/* NULL params selects the defaults. Returns NULL if index is out of range
+   or the instance is already open. */
+ECDSA_Handle ECDSA_open(uint_least8_t index, ECDSA_Params* params);
+
+void ECDSA_close(ECDSA_Handle handle);
+
+void ECDSA_OperationSign_init(ECDSA_OperationSign* operation);
+void ECDSA_OperationVerify_init(ECDSA_OperationVerify* operation);
+
+/* In callback mode ECDSA_STATUS_SUCCESS only means the operation started.
+   ECDSA_STATUS_RESOURCE_UNAVAILABLE is returned while another operation
+   is in progress on the handle. */
+int_fast16_t ECDSA_sign(ECDSA_Handle handle, ECDSA_OperationSign* operation);
+int_fast16_t ECDSA_verify(ECDSA_Handle handle, ECDSA_OperationVerify* operation);
+
+/* Abandon the operation in progress. In callback mode the callback is
+   called from here with ECDSA_STATUS_CANCELED, and the operation's result
+   buffers are not written. */
+int_fast16_t ECDSA_cancelOperation(ECDSA_Handle handle);
+
+#endif
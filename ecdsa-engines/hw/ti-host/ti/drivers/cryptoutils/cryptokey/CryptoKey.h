@@ -0,0 +1,63 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Linux stand-in for the TI CryptoKey type. Only plaintext keys are supported.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __TI_HOST_CRYPTOKEY_H
+#define __TI_HOST_CRYPTOKEY_H
+
+#include <stdint.h>
+
+#define CryptoKey_STATUS_SUCCESS                (0)
+#define CryptoKey_STATUS_ERROR                  (-1)
+
+typedef uint8_t CryptoKey_Encoding;
+
+#define CryptoKey_PLAINTEXT         0x02
+#define CryptoKey_BLANK_PLAINTEXT   0x04
+
+typedef struct
+{
+    uint8_t* keyMaterial;
+    uint16_t keyLength;
+} CryptoKey_Plaintext;
+
+typedef struct
+{
+    CryptoKey_Encoding encoding;
+    union
+    {
+        CryptoKey_Plaintext plaintext;
+    } u;
+} CryptoKey;
+
+#endif
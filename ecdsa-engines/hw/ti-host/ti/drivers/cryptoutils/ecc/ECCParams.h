@@ -0,0 +1,77 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Linux stand-in for the TI elliptic curve parameter definitions. Integers
+*    are little-endian, as the PKA takes them.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __TI_HOST_ECCPARAMS_H
+#define __TI_HOST_ECCPARAMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ECCParams_STATUS_SUCCESS    (0)
+#define ECCParams_STATUS_ERROR      (-1)
+
+typedef enum
+{
+    ECCParams_CURVE_TYPE_SHORT_WEIERSTRASS = 0,
+    ECCParams_CURVE_TYPE_MONTGOMERY,
+    ECCParams_CURVE_TYPE_EDWARDS,
+} ECCParams_CurveType;
+
+typedef struct
+{
+    ECCParams_CurveType curveType;
+    size_t length;              /* bytes per parameter */
+    const uint8_t* prime;
+    const uint8_t* order;
+    const uint8_t* a;
+    const uint8_t* b;
+    const uint8_t* generatorX;
+    const uint8_t* generatorY;
+} ECCParams_CurveParams;
+
+extern const ECCParams_CurveParams ECCParams_NISTP256;
+
+/**
+ *  Write the generator as an uncompressed point: 0x04, x, y.
+ *
+ *  @return ECCParams_STATUS_SUCCESS, or ECCParams_STATUS_ERROR if length
+ *  is not 2 * curveParams->length + 1.
+ */
+int_fast16_t ECCParams_getUncompressedGeneratorPoint(
+    const ECCParams_CurveParams* curveParams,
+    uint8_t* buffer,
+    size_t length);
+
+#endif
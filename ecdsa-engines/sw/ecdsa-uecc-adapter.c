@@ -34,10 +34,12 @@
 */
 
 #include <stdint.h>
-#include "ecdsa-engines\ecdsa-engine-impl.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
 #include "ecdsa-uecc-adapter.h"
 #include "uecc.h"
+#include "sha256.h"
 #include "dev/watchdog.h"
+#include "perf-cycles.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -64,17 +66,43 @@ static int fake_rng(uint8_t *p_dest, unsigned p_size)
 }
 #endif
 
+#if ECDSA_UECC_STATIC_WORKSPACE
+/* Shared by the one-shot operations below, which never interleave. */
+static uECC_Workspace g_workspace;
+#define UECC_MAKE_KEY(pub, priv)        uECC_make_key_ws(&g_workspace, pub, priv)
+#define UECC_SIGN(priv, hash, sig)      uECC_sign_ws(&g_workspace, priv, hash, sig)
+#define UECC_VERIFY(pub, hash, sig)     uECC_verify_ws(&g_workspace, pub, hash, sig)
+#else
+#define UECC_MAKE_KEY(pub, priv)        uECC_make_key(pub, priv)
+#define UECC_SIGN(priv, hash, sig)      uECC_sign(priv, hash, sig)
+#define UECC_VERIFY(pub, hash, sig)     uECC_verify(pub, hash, sig)
+#endif
+
+/* uECC takes a signature as one r || s array. The engine passes the r and s
+   of an ecdsa_signature_t, which lie back to back, so the backend hands
+   those over in place; only separate r and s buffers go through a copy.
+   The backend functions take r as a plain pointer since it then addresses
+   the whole signature. */
+#define UECC_SIG_IN_PLACE(r, s)         ((s) == (r) + 32)
+
 /* Initialize engine. */
 void ecdsa_uecc_init(rng_func func) 
 {
     uECC_set_rng(func);
 }
 
+int ecdsa_uecc_set_curve(ECDSA_UECC_CURVE curve)
+{
+    uECC_Curve l_curve = (curve == ECDSA_UECC_CURVE_NISTP256) ?
+        uECC_curve_secp256r1() : uECC_curve_secp256k1();
+    return uECC_set_curve(l_curve) ? 0 : -1;
+}
+
 int ecdsa_uecc_makekey(
     uint8_t pub_key[64],
     uint8_t priv_key[32])
 {
-    int result = uECC_make_key(pub_key, priv_key);
+    int result = UECC_MAKE_KEY(pub_key, priv_key);
     return (result == 1) ? 0 : -1;
 }
 
@@ -85,10 +113,20 @@ int ecdsa_uecc_hash(
     uint32_t len,
     uint8_t hash[32])
 {
+    sha256(message, len, hash);
     return 0;
 }
 
-/* Compute the ECDSA signature using the secp256k1 curve. */
+/* Derive the public key belonging to a private key. */
+int ecdsa_uecc_get_pubkey(
+    const uint8_t priv_key[32],
+    uint8_t pub_key[64])
+{
+    int result = uECC_get_pubkey(priv_key, pub_key);
+    return (result == 1) ? 0 : -1;
+}
+
+/* Compute the ECDSA signature using the selected curve. */
 int ecdsa_uecc_sign(
     const uint8_t priv_key[32],
     const uint8_t k[32],
@@ -96,23 +134,218 @@ int ecdsa_uecc_sign(
     uint8_t r[32],
     uint8_t s[32])
 {
-    int result = uECC_sign(priv_key, hash, r);
+    uint8_t sig[64];
+
+    /* uECC produces a contiguous r || s; r and s may be separate buffers. */
+    int result = UECC_SIGN(priv_key, hash, sig);
+    memcpy(r, sig, 32);
+    memcpy(s, sig + 32, 32);
     return (result == 1) ? 0 : -1;
 }
 
-/* Verify the ECDSA signature using the secp256k1 curve. */
+/* Verify the ECDSA signature using the selected curve. */
 int ecdsa_uecc_verify(
     const uint8_t pub_key[64],
     const uint8_t hash[32],
     uint8_t r[32],
     uint8_t s[32])
 {
-    int result = uECC_verify(pub_key, hash, r);
+    uint8_t sig[64];
+    int result;
+
+    memcpy(sig, r, 32);
+    memcpy(sig + 32, s, 32);
+    result = UECC_VERIFY(pub_key, hash, sig);
+    return (result == 1) ? 0 : -1;
+}
+
+/* Engine backend. uECC draws its own nonce from the RNG, so k is ignored. */
+
+#if uECC_MULTI_CURVE && (uECC_CURVE == uECC_secp256k1 || uECC_CURVE == uECC_secp256r1)
+#define UECC_BACKEND_CAPS   (ECDSA_CAP_SECP256K1 | ECDSA_CAP_SECP256R1)
+#elif uECC_CURVE == uECC_secp256r1
+#define UECC_BACKEND_CAPS   ECDSA_CAP_SECP256R1
+#else
+#define UECC_BACKEND_CAPS   ECDSA_CAP_SECP256K1
+#endif
+
+static int uecc_backend_init(void)
+{
+    return 0;
+}
+
+static int uecc_backend_set_curve(ecdsa_curve_t curve)
+{
+    return ecdsa_uecc_set_curve((curve == ECDSA_CURVE_SECP256R1) ?
+        ECDSA_UECC_CURVE_NISTP256 : ECDSA_UECC_CURVE_SECP256K1);
+}
+
+static int uecc_backend_sign(
+    const uint8_t priv_key[32],
+    const uint8_t k[32],
+    const uint8_t hash[32],
+    uint8_t* r,
+    uint8_t* s)
+{
+    if(UECC_SIG_IN_PLACE(r, s))
+    {
+        return (UECC_SIGN(priv_key, hash, r) == 1) ? 0 : -1;
+    }
+    return ecdsa_uecc_sign(priv_key, k, hash, r, s);
+}
+
+static int uecc_backend_verify(
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    uint8_t* r,
+    uint8_t* s)
+{
+    if(UECC_SIG_IN_PLACE(r, s))
+    {
+        return (UECC_VERIFY(pub_key, hash, r) == 1) ? 0 : -1;
+    }
+    return ecdsa_uecc_verify(pub_key, hash, r, s);
+}
+
+static int uecc_backend_recover(
+    const uint8_t hash[32],
+    const uint8_t* r,
+    const uint8_t* s,
+    int recid,
+    uint8_t pub_key[64])
+{
+    uint8_t sig[64];
+
+    if(UECC_SIG_IN_PLACE(r, s))
+    {
+        return uECC_recover(hash, r, recid, pub_key) ? 0 : -1;
+    }
+
+    memcpy(sig, r, 32);
+    memcpy(sig + 32, s, 32);
+    return uECC_recover(hash, sig, recid, pub_key) ? 0 : -1;
+}
+
+static int uecc_backend_random(uint8_t k[32])
+{
+    return uECC_get_rng()(k, 32) ? 0 : -1;
+}
+
+/* The signatures are handed to uECC as contiguous r || s arrays. */
+typedef char uecc_signature_is_r_s[(sizeof(ecdsa_signature_t) == 2 * uECC_BYTES) ? 1 : -1];
+
+static int uecc_backend_sign_batch(
+    const uint8_t priv_key[32],
+    const uint8_t hashes[][32],
+    ecdsa_signature_t sigs[],
+    uint32_t count)
+{
+    return uECC_sign_batch(priv_key, hashes, (uint8_t (*)[uECC_BYTES * 2])sigs, count) ? 0 : -1;
+}
+
+typedef char uecc_sign_ctx_fits[(sizeof(uECC_SignContext) <= ECDSA_STEP_CTX_SIZE) ? 1 : -1];
+typedef char uecc_verify_ctx_fits[(sizeof(uECC_VerifyContext) <= ECDSA_STEP_CTX_SIZE) ? 1 : -1];
+
+static int uecc_backend_sign_begin(
+    void* ctx,
+    const uint8_t priv_key[32],
+    const uint8_t k[32],
+    const uint8_t hash[32])
+{
+    return uECC_sign_begin((uECC_SignContext*)ctx, priv_key, hash) ? 0 : -1;
+}
+
+static int uecc_backend_sign_step(
+    void* ctx,
+    unsigned iterations,
+    uint8_t* r,
+    uint8_t* s)
+{
+    uint8_t sig[64];
+    int result;
+
+    if(UECC_SIG_IN_PLACE(r, s))
+    {
+        result = uECC_sign_step((uECC_SignContext*)ctx, iterations, r);
+        return (result == uECC_IN_PROGRESS) ? ECDSA_STEP_AGAIN : ((result == 1) ? 0 : -1);
+    }
+
+    result = uECC_sign_step((uECC_SignContext*)ctx, iterations, sig);
+    if(result == uECC_IN_PROGRESS)
+    {
+        return ECDSA_STEP_AGAIN;
+    }
+    memcpy(r, sig, 32);
+    memcpy(s, sig + 32, 32);
+    return (result == 1) ? 0 : -1;
+}
+
+static int uecc_backend_verify_begin(
+    void* ctx,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const uint8_t* r,
+    const uint8_t* s)
+{
+    uint8_t sig[64];
+
+    if(UECC_SIG_IN_PLACE(r, s))
+    {
+        return uECC_verify_begin((uECC_VerifyContext*)ctx, pub_key, hash, r) ? 0 : -1;
+    }
+
+    memcpy(sig, r, 32);
+    memcpy(sig + 32, s, 32);
+    return uECC_verify_begin((uECC_VerifyContext*)ctx, pub_key, hash, sig) ? 0 : -1;
+}
+
+static int uecc_backend_verify_step(
+    void* ctx,
+    unsigned iterations)
+{
+    int result = uECC_verify_step((uECC_VerifyContext*)ctx, iterations);
+
+    if(result == uECC_IN_PROGRESS)
+    {
+        return ECDSA_STEP_AGAIN;
+    }
     return (result == 1) ? 0 : -1;
 }
 
+const ecdsa_engine_backend_t ecdsa_uecc_backend = {
+    .name = "uecc",
+    .caps = UECC_BACKEND_CAPS | ECDSA_CAP_RECOVERY | ECDSA_CAP_OWN_NONCE,
+    .init = uecc_backend_init,
+    .set_curve = uecc_backend_set_curve,
+    .random = uecc_backend_random,
+    .hash = ecdsa_uecc_hash,
+    .get_pubkey = ecdsa_uecc_get_pubkey,
+    .sign = uecc_backend_sign,
+    .verify = uecc_backend_verify,
+    .sign_batch = uecc_backend_sign_batch,
+    .recover = uecc_backend_recover,
+    .sign_begin = uecc_backend_sign_begin,
+    .sign_step = uecc_backend_sign_step,
+    .verify_begin = uecc_backend_verify_begin,
+    .verify_step = uecc_backend_verify_step,
+    .cancel = NULL,
+};
+
 #define NUM_ITER  1
 
+#if uECC_PROFILE
+static void print_counters(const char* op)
+{
+    uECC_Counters c;
+
+    uECC_get_counters(&c);
+    printf("%s ops: modMult=%lu modSquare=%lu modInv=%lu modMult_n=%lu XYcZ_add=%lu double=%lu rng=%lu\n",
+        op, (unsigned long)c.modMult, (unsigned long)c.modSquare, (unsigned long)c.modInv,
+        (unsigned long)c.modMult_n, (unsigned long)c.XYcZ_add, (unsigned long)c.double_jacobian,
+        (unsigned long)c.rng);
+}
+#endif
+
 static void print_hex(uint8_t* buf, int len) {
     for (int i = 0; i < len; i++) {
         printf("%02x", buf[i]);
@@ -132,14 +365,17 @@ void ecdsa_uecc_test()
 
     int i;
 
-    int min = 0xFFFFFFFF;
-    int max = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
     uint64_t accum = 0;
 
+    perf_init();
+
     printf("Micro ECC Configuration:\n");
     printf("  uECC_CURVE=%d\n", uECC_CURVE);
     printf("  uECC_ASM=%d\n", uECC_ASM);
     printf("  uECC_BYTES=%d\n", uECC_BYTES);
+    printf("  uECC_WORD_SIZE=%u\n", uECC_word_size());
 
     printf("Testing Micro ECC 256 signatures\n");
 
@@ -151,20 +387,26 @@ void ecdsa_uecc_test()
             printf("uECC_make_key() failed\n");
             continue;
         }
+#if uECC_PROFILE
+        print_counters("make_key");
+#endif
         watchdog_periodic();
         print_hex(l_public, uECC_BYTES * 2);
         print_hex(l_private, uECC_BYTES);
         memcpy(l_hash, l_public, uECC_BYTES);
 
         LOG_INFO("uECC_sign\n");
-        uint32_t start = clock_time();
+        uint64_t start = perf_cycles();
         if (!uECC_sign(l_private, l_hash, l_sig))
         {
             printf("uECC_sign() failed\n");
             continue;
         }
-        uint32_t time = clock_time() - start;
+        uint64_t time = perf_cycles() - start;
         watchdog_periodic();
+#if uECC_PROFILE
+        print_counters("sign");
+#endif
 
         if (time < min) { min = time; }
         if (time > max) { max = time; }
@@ -175,12 +417,16 @@ void ecdsa_uecc_test()
         {
             printf("uECC_verify() failed\n");
         }
+#if uECC_PROFILE
+        print_counters("verify");
+#endif
         watchdog_periodic();
     }
-    int avg = accum / NUM_ITER;
-    printf("\nSign results (ms): avg=%d min=%d max=%d\n",
-        (avg * 1000) / CLOCK_SECOND,
-        (min * 1000) / CLOCK_SECOND,
-        (max * 1000) / CLOCK_SECOND);
+    uint64_t avg = accum / NUM_ITER;
+    printf("\nSign results (%s cycles, ns): avg=%lu,%lu min=%lu,%lu max=%lu,%lu\n",
+        perf_source_name(),
+        (unsigned long)avg, (unsigned long)perf_cycles_to_ns(avg),
+        (unsigned long)min, (unsigned long)perf_cycles_to_ns(min),
+        (unsigned long)max, (unsigned long)perf_cycles_to_ns(max));
 
 }
\ No newline at end of file
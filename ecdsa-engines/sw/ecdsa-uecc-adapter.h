@@ -35,6 +35,22 @@
 #ifndef __ECDSA_EUCC_ADAPTER_H
 #define __ECDSA_EUCC_ADAPTER_H
 
+/* ECDSA_UECC_STATIC_WORKSPACE - If enabled (defined as nonzero), key generation,
+   signing and verification keep their working state in one static arena of
+   uECC_WORKSPACE_SIZE bytes instead of on the calling process's stack.
+   Override with ECDSA_UECC_CONF_STATIC_WORKSPACE. */
+#ifdef ECDSA_UECC_CONF_STATIC_WORKSPACE
+#define ECDSA_UECC_STATIC_WORKSPACE ECDSA_UECC_CONF_STATIC_WORKSPACE
+#else
+#define ECDSA_UECC_STATIC_WORKSPACE 1
+#endif
+
+typedef enum
+{
+    ECDSA_UECC_CURVE_SECP256K1,
+    ECDSA_UECC_CURVE_NISTP256,
+} ECDSA_UECC_CURVE;
+
 int ecdsa_uecc_makekey(
     uint8_t pub_key[64],
     uint8_t priv_key[32]);
@@ -45,13 +61,21 @@ typedef int(*rng_func)(uint8_t *p_dest, unsigned p_size);
 /* Initialize engine. */
 void ecdsa_uecc_init(rng_func func);
 
+/* Select the curve for subsequent operations. Returns -1 if it is not built in. */
+int ecdsa_uecc_set_curve(ECDSA_UECC_CURVE curve);
+
 /* Get the SHA-256 hash of the message. */
 int ecdsa_uecc_hash(
     const uint8_t* message,
     uint32_t len,
     uint8_t hash[32]);
 
-/* Compute the ECDSA signature using the secp256k1 curve. */
+/* Derive the public key belonging to a private key. */
+int ecdsa_uecc_get_pubkey(
+    const uint8_t priv_key[32],
+    uint8_t pub_key[64]);
+
+/* Compute the ECDSA signature using the selected curve. */
 int ecdsa_uecc_sign(
     const uint8_t priv_key[32],
     const uint8_t k[32],
@@ -59,7 +83,7 @@ int ecdsa_uecc_sign(
     uint8_t r[32],
     uint8_t s[32]);
 
-/* Verify the ECDSA signature using the secp256k1 curve. */
+/* Verify the ECDSA signature using the selected curve. */
 int ecdsa_uecc_verify(
     const uint8_t pub_key[64],
     const uint8_t hash[32],
@@ -0,0 +1,171 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    HMAC-SHA256 and HKDF-SHA256.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "hmac-sha256.h"
+
+void hmac_sha256_key_init(hmac_sha256_key_t* key, const uint8_t* k, uint32_t len)
+{
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    sha256_ctx_t ctx;
+    uint32_t i;
+
+    memset(pad, 0, sizeof(pad));
+    if(len > SHA256_BLOCK_SIZE)
+    {
+        sha256(k, len, pad);
+    }
+    else
+    {
+        memcpy(pad, k, len);
+    }
+
+    for(i = 0; i < SHA256_BLOCK_SIZE; ++i)
+    {
+        pad[i] ^= 0x36;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, SHA256_BLOCK_SIZE);
+    sha256_save(&ctx, &key->inner);
+
+    for(i = 0; i < SHA256_BLOCK_SIZE; ++i)
+    {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, SHA256_BLOCK_SIZE);
+    sha256_save(&ctx, &key->outer);
+
+    memset(pad, 0, sizeof(pad));
+}
+
+void hmac_sha256_init(hmac_sha256_ctx_t* ctx, const hmac_sha256_key_t* key)
+{
+    ctx->key = key;
+    sha256_restore(&ctx->sha, &key->inner);
+}
+
+void hmac_sha256_update(hmac_sha256_ctx_t* ctx, const uint8_t* data, uint32_t len)
+{
+    sha256_update(&ctx->sha, data, len);
+}
+
+void hmac_sha256_final(hmac_sha256_ctx_t* ctx, uint8_t mac[SHA256_DIGEST_SIZE])
+{
+    uint8_t inner[SHA256_DIGEST_SIZE];
+
+    sha256_final(&ctx->sha, inner);
+    sha256_restore(&ctx->sha, &ctx->key->outer);
+    sha256_update(&ctx->sha, inner, SHA256_DIGEST_SIZE);
+    sha256_final(&ctx->sha, mac);
+}
+
+void hmac_sha256(
+    const uint8_t* k,
+    uint32_t key_len,
+    const uint8_t* data,
+    uint32_t len,
+    uint8_t mac[SHA256_DIGEST_SIZE])
+{
+    hmac_sha256_key_t key;
+    hmac_sha256_ctx_t ctx;
+
+    hmac_sha256_key_init(&key, k, key_len);
+    hmac_sha256_init(&ctx, &key);
+    hmac_sha256_update(&ctx, data, len);
+    hmac_sha256_final(&ctx, mac);
+    memset(&key, 0, sizeof(key));
+}
+
+void hkdf_sha256_extract(
+    const uint8_t* salt,
+    uint32_t salt_len,
+    const uint8_t* ikm,
+    uint32_t ikm_len,
+    uint8_t prk[SHA256_DIGEST_SIZE])
+{
+    static const uint8_t zero_salt[SHA256_DIGEST_SIZE] = { 0 };
+
+    if(salt == NULL || salt_len == 0)
+    {
+        salt = zero_salt;
+        salt_len = sizeof(zero_salt);
+    }
+    hmac_sha256(salt, salt_len, ikm, ikm_len, prk);
+}
+
+int hkdf_sha256_expand(
+    const uint8_t prk[SHA256_DIGEST_SIZE],
+    const uint8_t* info,
+    uint32_t info_len,
+    uint8_t* okm,
+    uint32_t okm_len)
+{
+    hmac_sha256_key_t key;
+    hmac_sha256_ctx_t ctx;
+    uint8_t t[SHA256_DIGEST_SIZE];
+    uint8_t counter = 1;
+    uint32_t n;
+
+    if(okm_len > 255 * SHA256_DIGEST_SIZE)
+    {
+        return -1;
+    }
+
+    hmac_sha256_key_init(&key, prk, SHA256_DIGEST_SIZE);
+
+    /* T(i) = HMAC(prk, T(i-1) || info || i) */
+    while(okm_len)
+    {
+        hmac_sha256_init(&ctx, &key);
+        if(counter > 1)
+        {
+            hmac_sha256_update(&ctx, t, SHA256_DIGEST_SIZE);
+        }
+        hmac_sha256_update(&ctx, info, info_len);
+        hmac_sha256_update(&ctx, &counter, 1);
+        hmac_sha256_final(&ctx, t);
+
+        n = (okm_len < SHA256_DIGEST_SIZE) ? okm_len : SHA256_DIGEST_SIZE;
+        memcpy(okm, t, n);
+        okm += n;
+        okm_len -= n;
+        ++counter;
+    }
+
+    memset(&key, 0, sizeof(key));
+    memset(t, 0, sizeof(t));
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    HMAC-SHA256 and HKDF-SHA256 (RFC 2104, RFC 5869) for deriving and using
+*    session keys.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __HMAC_SHA256_H
+#define __HMAC_SHA256_H
+
+#include <stdint.h>
+#include "sha256.h"
+
+/* Key schedule: SHA-256 states after absorbing the inner and outer padded key.
+   Computing it once per key leaves two compressions plus the message blocks
+   for each MAC. */
+typedef struct
+{
+    sha256_midstate_t inner;
+    sha256_midstate_t outer;
+} hmac_sha256_key_t;
+
+typedef struct
+{
+    sha256_ctx_t sha;
+    const hmac_sha256_key_t* key;
+} hmac_sha256_ctx_t;
+
+/**
+ *  Precompute the key schedule for a key of any length.
+ */
+void hmac_sha256_key_init(hmac_sha256_key_t* key, const uint8_t* k, uint32_t len);
+
+/**
+ *  Start a MAC. The key schedule must stay valid until hmac_sha256_final().
+ */
+void hmac_sha256_init(hmac_sha256_ctx_t* ctx, const hmac_sha256_key_t* key);
+
+/**
+ *  Absorb the next chunk of the message.
+ */
+void hmac_sha256_update(hmac_sha256_ctx_t* ctx, const uint8_t* data, uint32_t len);
+
+/**
+ *  Write out the MAC.
+ */
+void hmac_sha256_final(hmac_sha256_ctx_t* ctx, uint8_t mac[SHA256_DIGEST_SIZE]);
+
+/**
+ *  One-shot MAC of a contiguous message.
+ */
+void hmac_sha256(
+    const uint8_t* k,
+    uint32_t key_len,
+    const uint8_t* data,
+    uint32_t len,
+    uint8_t mac[SHA256_DIGEST_SIZE]);
+
+/**
+ *  HKDF extract: prk = HMAC(salt, ikm). A NULL or empty salt means 32 zero bytes.
+ */
+void hkdf_sha256_extract(
+    const uint8_t* salt,
+    uint32_t salt_len,
+    const uint8_t* ikm,
+    uint32_t ikm_len,
+    uint8_t prk[SHA256_DIGEST_SIZE]);
+
+/**
+ *  HKDF expand: fill okm with okm_len bytes of keying material bound to info.
+ *
+ *  @return 0 - success, -1 if okm_len exceeds 255 * 32 bytes.
+ */
+int hkdf_sha256_expand(
+    const uint8_t prk[SHA256_DIGEST_SIZE],
+    const uint8_t* info,
+    uint32_t info_len,
+    uint8_t* okm,
+    uint32_t okm_len);
+
+#endif
@@ -0,0 +1,198 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    RIPEMD-160 (Dobbertin, Bosselaers, Preneel). Compact rolled form: it only
+*    ever sees a block or two of key material per call.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "ripemd160.h"
+
+/* Message word selection and rotation amounts for the left and right lines. */
+static const uint8_t RL[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13 };
+
+static const uint8_t RR[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11 };
+
+static const uint8_t SL[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6 };
+
+static const uint8_t SR[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11 };
+
+static const uint32_t KL[5] = { 0x00000000, 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xA953FD4E };
+static const uint32_t KR[5] = { 0x50A28BE6, 0x5C4DD124, 0x6D703EF3, 0x7A6D76E9, 0x00000000 };
+
+#define ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+/* Boolean function of round j (0..4). */
+static uint32_t f(int j, uint32_t x, uint32_t y, uint32_t z)
+{
+    switch(j)
+    {
+    case 0: return x ^ y ^ z;
+    case 1: return (x & y) | (~x & z);
+    case 2: return (x | ~y) ^ z;
+    case 3: return (x & z) | (y & ~z);
+    default: return x ^ (y | ~z);
+    }
+}
+
+static void compress(uint32_t state[5], const uint8_t block[RIPEMD160_BLOCK_SIZE])
+{
+    uint32_t X[16];
+    uint32_t al, bl, cl, dl, el;
+    uint32_t ar, br, cr, dr, er;
+    uint32_t t;
+    int i;
+
+    for(i = 0; i < 16; ++i)
+    {
+        X[i] = (uint32_t)block[4 * i] | ((uint32_t)block[4 * i + 1] << 8) |
+            ((uint32_t)block[4 * i + 2] << 16) | ((uint32_t)block[4 * i + 3] << 24);
+    }
+
+    al = ar = state[0];
+    bl = br = state[1];
+    cl = cr = state[2];
+    dl = dr = state[3];
+    el = er = state[4];
+
+    for(i = 0; i < 80; ++i)
+    {
+        int j = i >> 4;
+
+        t = al + f(j, bl, cl, dl) + X[RL[i]] + KL[j];
+        t = ROL(t, SL[i]) + el;
+        al = el; el = dl; dl = ROL(cl, 10); cl = bl; bl = t;
+
+        t = ar + f(4 - j, br, cr, dr) + X[RR[i]] + KR[j];
+        t = ROL(t, SR[i]) + er;
+        ar = er; er = dr; dr = ROL(cr, 10); cr = br; br = t;
+    }
+
+    t = state[1] + cl + dr;
+    state[1] = state[2] + dl + er;
+    state[2] = state[3] + el + ar;
+    state[3] = state[4] + al + br;
+    state[4] = state[0] + bl + cr;
+    state[0] = t;
+}
+
+void ripemd160_init(ripemd160_ctx_t* ctx)
+{
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xEFCDAB89;
+    ctx->state[2] = 0x98BADCFE;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xC3D2E1F0;
+    ctx->count = 0;
+}
+
+void ripemd160_update(ripemd160_ctx_t* ctx, const uint8_t* data, uint32_t len)
+{
+    uint32_t used = (uint32_t)ctx->count & (RIPEMD160_BLOCK_SIZE - 1);
+
+    ctx->count += len;
+
+    while(len)
+    {
+        uint32_t n = RIPEMD160_BLOCK_SIZE - used;
+        if(n > len)
+        {
+            n = len;
+        }
+        memcpy(ctx->buffer + used, data, n);
+        used += n;
+        data += n;
+        len -= n;
+        if(used == RIPEMD160_BLOCK_SIZE)
+        {
+            compress(ctx->state, ctx->buffer);
+            used = 0;
+        }
+    }
+}
+
+void ripemd160_final(ripemd160_ctx_t* ctx, uint8_t digest[RIPEMD160_DIGEST_SIZE])
+{
+    uint32_t used = (uint32_t)ctx->count & (RIPEMD160_BLOCK_SIZE - 1);
+    uint64_t bits = ctx->count << 3;
+    int i;
+
+    ctx->buffer[used++] = 0x80;
+    if(used > RIPEMD160_BLOCK_SIZE - 8)
+    {
+        memset(ctx->buffer + used, 0, RIPEMD160_BLOCK_SIZE - used);
+        compress(ctx->state, ctx->buffer);
+        used = 0;
+    }
+    memset(ctx->buffer + used, 0, RIPEMD160_BLOCK_SIZE - 8 - used);
+    for(i = 0; i < 8; ++i)
+    {
+        ctx->buffer[RIPEMD160_BLOCK_SIZE - 8 + i] = (uint8_t)(bits >> (8 * i));
+    }
+    compress(ctx->state, ctx->buffer);
+
+    for(i = 0; i < 5; ++i)
+    {
+        digest[4 * i] = (uint8_t)ctx->state[i];
+        digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4 * i + 3] = (uint8_t)(ctx->state[i] >> 24);
+    }
+}
+
+void ripemd160(const uint8_t* data, uint32_t len, uint8_t digest[RIPEMD160_DIGEST_SIZE])
+{
+    ripemd160_ctx_t ctx;
+    ripemd160_init(&ctx);
+    ripemd160_update(&ctx, data, len);
+    ripemd160_final(&ctx, digest);
+}
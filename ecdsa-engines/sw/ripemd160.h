@@ -0,0 +1,61 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    RIPEMD-160, used for the checksums of EOS key and signature strings.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __RIPEMD160_H
+#define __RIPEMD160_H
+
+#include <stdint.h>
+
+#define RIPEMD160_BLOCK_SIZE   64
+#define RIPEMD160_DIGEST_SIZE  20
+
+typedef struct
+{
+    uint32_t state[5];
+    uint64_t count;         /* total number of message bytes absorbed */
+    uint8_t buffer[RIPEMD160_BLOCK_SIZE];
+} ripemd160_ctx_t;
+
+void ripemd160_init(ripemd160_ctx_t* ctx);
+
+void ripemd160_update(ripemd160_ctx_t* ctx, const uint8_t* data, uint32_t len);
+
+void ripemd160_final(ripemd160_ctx_t* ctx, uint8_t digest[RIPEMD160_DIGEST_SIZE]);
+
+/**
+ *  One-shot digest of a contiguous message.
+ */
+void ripemd160(const uint8_t* data, uint32_t len, uint8_t digest[RIPEMD160_DIGEST_SIZE]);
+
+#endif
@@ -0,0 +1,128 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    SHA-256 compression using the ARMv8 cryptography extensions.
+*    Only built for AArch64 host targets (gateway, provisioning and bench tools).
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include "sha256-kernels.h"
+
+#if SHA256_HW_ACCEL && defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+
+#if defined(__clang__)
+#define ARMV8_CE_TARGET __attribute__((target("crypto")))
+#else
+#define ARMV8_CE_TARGET __attribute__((target("+crypto")))
+#endif
+
+int sha256_armv8_supported(void)
+{
+#if defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+    return 1;
+#elif defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#elif defined(__APPLE__)
+    return 1; /* every Apple arm64 core implements the SHA-256 instructions */
+#else
+    return 0;
+#endif
+}
+
+/* Four rounds on message words M, i is the round group. */
+#define QROUND(M, i) do { \
+    TMP0 = vaddq_u32((M), vld1q_u32(&sha256_K[4 * (i)])); \
+    TMP1 = STATE0; \
+    STATE0 = vsha256hq_u32(STATE0, STATE1, TMP0); \
+    STATE1 = vsha256h2q_u32(STATE1, TMP1, TMP0); \
+    } while(0)
+
+/* M0 = W[i..i+3] from W[i-16..i-1] held in M0..M3. */
+#define SCHED(M0, M1, M2, M3) do { \
+    M0 = vsha256su1q_u32(vsha256su0q_u32(M0, M1), M2, M3); \
+    } while(0)
+
+ARMV8_CE_TARGET
+void sha256_compress_armv8(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    uint32x4_t STATE0, STATE1, ABCD_SAVE, EFGH_SAVE;
+    uint32x4_t MSG0, MSG1, MSG2, MSG3;
+    uint32x4_t TMP0, TMP1;
+
+    STATE0 = vld1q_u32(&state[0]);
+    STATE1 = vld1q_u32(&state[4]);
+
+    while(nblocks--)
+    {
+        ABCD_SAVE = STATE0;
+        EFGH_SAVE = STATE1;
+
+        MSG0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 0)));
+        MSG1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16)));
+        MSG2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 32)));
+        MSG3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 48)));
+        blocks += SHA256_BLOCK_SIZE;
+
+        QROUND(MSG0, 0);
+        QROUND(MSG1, 1);
+        QROUND(MSG2, 2);
+        QROUND(MSG3, 3);
+
+        SCHED(MSG0, MSG1, MSG2, MSG3); QROUND(MSG0, 4);
+        SCHED(MSG1, MSG2, MSG3, MSG0); QROUND(MSG1, 5);
+        SCHED(MSG2, MSG3, MSG0, MSG1); QROUND(MSG2, 6);
+        SCHED(MSG3, MSG0, MSG1, MSG2); QROUND(MSG3, 7);
+        SCHED(MSG0, MSG1, MSG2, MSG3); QROUND(MSG0, 8);
+        SCHED(MSG1, MSG2, MSG3, MSG0); QROUND(MSG1, 9);
+        SCHED(MSG2, MSG3, MSG0, MSG1); QROUND(MSG2, 10);
+        SCHED(MSG3, MSG0, MSG1, MSG2); QROUND(MSG3, 11);
+        SCHED(MSG0, MSG1, MSG2, MSG3); QROUND(MSG0, 12);
+        SCHED(MSG1, MSG2, MSG3, MSG0); QROUND(MSG1, 13);
+        SCHED(MSG2, MSG3, MSG0, MSG1); QROUND(MSG2, 14);
+        SCHED(MSG3, MSG0, MSG1, MSG2); QROUND(MSG3, 15);
+
+        STATE0 = vaddq_u32(STATE0, ABCD_SAVE);
+        STATE1 = vaddq_u32(STATE1, EFGH_SAVE);
+    }
+
+    vst1q_u32(&state[0], STATE0);
+    vst1q_u32(&state[4], STATE1);
+}
+
+#endif /* SHA256_HW_ACCEL && __aarch64__ */
@@ -0,0 +1,274 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    8-lane multi-buffer SHA-256 using AVX2. Each 32-bit lane of a 256-bit
+*    register carries an independent message, so eight short digests are
+*    computed for roughly the cost of one. Only built for x86 host targets.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <string.h>
+#include "sha256-kernels.h"
+
+#if SHA256_HW_ACCEL && (defined(__x86_64__) || defined(__i386__))
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+int sha256_avx2_supported(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+    {
+        return 0;
+    }
+    /* The OS must save the YMM registers on context switch. */
+    __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    if((eax & 0x6) != 0x6)
+    {
+        return 0;
+    }
+    if(__get_cpuid_max(0, 0) < 7)
+    {
+        return 0;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & bit_AVX2) != 0;
+}
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+#define ROTR8(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define XOR3(a, b, c) _mm256_xor_si256(_mm256_xor_si256((a), (b)), (c))
+#define ADD(a, b) _mm256_add_epi32((a), (b))
+
+#define BSIG0(x) XOR3(ROTR8(x, 2), ROTR8(x, 13), ROTR8(x, 22))
+#define BSIG1(x) XOR3(ROTR8(x, 6), ROTR8(x, 11), ROTR8(x, 25))
+#define SSIG0(x) XOR3(ROTR8(x, 7), ROTR8(x, 18), _mm256_srli_epi32((x), 3))
+#define SSIG1(x) XOR3(ROTR8(x, 17), ROTR8(x, 19), _mm256_srli_epi32((x), 10))
+#define CH8(x, y, z) _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define MAJ8(x, y, z) _mm256_or_si256(_mm256_and_si256((x), (y)), _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+
+/* Message schedule on a 16-word ring: W[i] is replaced by W[i+16]. */
+#define WSCHED(i) (W[(i) & 15] = ADD(ADD(W[(i) & 15], SSIG1(W[((i) - 2) & 15])), \
+    ADD(W[((i) - 7) & 15], SSIG0(W[((i) - 15) & 15]))))
+
+#define RND(a, b, c, d, e, f, g, h, i, w) do { \
+    t1 = ADD(ADD(ADD(h, BSIG1(e)), CH8(e, f, g)), ADD(_mm256_set1_epi32((int)sha256_K[i]), (w))); \
+    d = ADD(d, t1); \
+    h = ADD(t1, ADD(BSIG0(a), MAJ8(a, b, c))); \
+    } while(0)
+
+#define RND8(i, w0, w1, w2, w3, w4, w5, w6, w7) \
+    RND(a, b, c, d, e, f, g, h, (i) + 0, w0); \
+    RND(h, a, b, c, d, e, f, g, (i) + 1, w1); \
+    RND(g, h, a, b, c, d, e, f, (i) + 2, w2); \
+    RND(f, g, h, a, b, c, d, e, (i) + 3, w3); \
+    RND(e, f, g, h, a, b, c, d, (i) + 4, w4); \
+    RND(d, e, f, g, h, a, b, c, (i) + 5, w5); \
+    RND(c, d, e, f, g, h, a, b, (i) + 6, w6); \
+    RND(b, c, d, e, f, g, h, a, (i) + 7, w7)
+
+#define RND16_LOAD(i) \
+    RND8((i), W[0], W[1], W[2], W[3], W[4], W[5], W[6], W[7]); \
+    RND8((i) + 8, W[8], W[9], W[10], W[11], W[12], W[13], W[14], W[15])
+
+#define RND16_SCHED(i) \
+    RND8((i), WSCHED((i) + 0), WSCHED((i) + 1), WSCHED((i) + 2), WSCHED((i) + 3), \
+        WSCHED((i) + 4), WSCHED((i) + 5), WSCHED((i) + 6), WSCHED((i) + 7)); \
+    RND8((i) + 8, WSCHED((i) + 8), WSCHED((i) + 9), WSCHED((i) + 10), WSCHED((i) + 11), \
+        WSCHED((i) + 12), WSCHED((i) + 13), WSCHED((i) + 14), WSCHED((i) + 15))
+
+/* Transpose an 8x8 matrix of 32-bit words held in r[0..7]. */
+AVX2_TARGET
+static void transpose8(__m256i r[8])
+{
+    __m256i t0, t1, t2, t3, t4, t5, t6, t7;
+    __m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+    t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    u0 = _mm256_unpacklo_epi64(t0, t2);
+    u1 = _mm256_unpackhi_epi64(t0, t2);
+    u2 = _mm256_unpacklo_epi64(t1, t3);
+    u3 = _mm256_unpackhi_epi64(t1, t3);
+    u4 = _mm256_unpacklo_epi64(t4, t6);
+    u5 = _mm256_unpackhi_epi64(t4, t6);
+    u6 = _mm256_unpacklo_epi64(t5, t7);
+    u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/* One block of each lane: load, transpose to word-sliced form and compress. */
+AVX2_TARGET
+static void compress8(__m256i S[8], const uint8_t* const block[8])
+{
+    const __m256i BSWAP = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m256i W[16];
+    __m256i a, b, c, d, e, f, g, h, t1;
+    int i;
+
+    for(i = 0; i < 8; ++i)
+    {
+        W[i] = _mm256_loadu_si256((const __m256i*)block[i]);
+        W[i + 8] = _mm256_loadu_si256((const __m256i*)(block[i] + 32));
+    }
+    transpose8(W);
+    transpose8(W + 8);
+    for(i = 0; i < 16; ++i)
+    {
+        W[i] = _mm256_shuffle_epi8(W[i], BSWAP);
+    }
+
+    a = S[0]; b = S[1]; c = S[2]; d = S[3];
+    e = S[4]; f = S[5]; g = S[6]; h = S[7];
+
+    RND16_LOAD(0);
+    RND16_SCHED(16);
+    RND16_SCHED(32);
+    RND16_SCHED(48);
+
+    S[0] = ADD(S[0], a); S[1] = ADD(S[1], b); S[2] = ADD(S[2], c); S[3] = ADD(S[3], d);
+    S[4] = ADD(S[4], e); S[5] = ADD(S[5], f); S[6] = ADD(S[6], g); S[7] = ADD(S[7], h);
+}
+
+/* Block number blk of the padded message: a pointer into the message itself
+   while the block lies entirely within it, otherwise built in scratch. */
+static const uint8_t* lane_block(const uint8_t* msg, uint32_t len, uint32_t blk, uint32_t nblocks,
+    uint8_t scratch[SHA256_BLOCK_SIZE])
+{
+    uint32_t off = blk * SHA256_BLOCK_SIZE;
+    uint64_t bits = (uint64_t)len << 3;
+    int i;
+
+    if(off + SHA256_BLOCK_SIZE <= len)
+    {
+        return msg + off;
+    }
+
+    memset(scratch, 0, SHA256_BLOCK_SIZE);
+    if(off <= len)
+    {
+        memcpy(scratch, msg + off, len - off);
+        scratch[len - off] = 0x80;
+    }
+    if(blk == nblocks - 1)
+    {
+        for(i = 0; i < 8; ++i)
+        {
+            scratch[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+        }
+    }
+    return scratch;
+}
+
+AVX2_TARGET
+void sha256_x8_avx2(const uint8_t* const msgs[], const uint32_t lens[],
+    uint8_t digests[][SHA256_DIGEST_SIZE], uint32_t lanes)
+{
+    static const uint8_t l_zero[SHA256_BLOCK_SIZE];
+    static const uint32_t H0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    uint8_t scratch[8][SHA256_BLOCK_SIZE];
+    const uint8_t* block[8];
+    uint32_t nblocks[8];
+    uint32_t maxblocks = 0;
+    __m256i S[8], T[8], active;
+    __m256i vblocks;
+    uint32_t blk;
+    uint32_t l, i;
+
+    for(l = 0; l < 8; ++l)
+    {
+        nblocks[l] = (l < lanes) ? (lens[l] + 9 + SHA256_BLOCK_SIZE - 1) / SHA256_BLOCK_SIZE : 0;
+        if(nblocks[l] > maxblocks)
+        {
+            maxblocks = nblocks[l];
+        }
+    }
+    for(i = 0; i < 8; ++i)
+    {
+        S[i] = _mm256_set1_epi32((int)H0[i]);
+    }
+    vblocks = _mm256_loadu_si256((const __m256i*)nblocks);
+
+    for(blk = 0; blk < maxblocks; ++blk)
+    {
+        for(l = 0; l < 8; ++l)
+        {
+            block[l] = (blk < nblocks[l]) ? lane_block(msgs[l], lens[l], blk, nblocks[l], scratch[l]) : l_zero;
+        }
+        for(i = 0; i < 8; ++i)
+        {
+            T[i] = S[i];
+        }
+        compress8(T, block);
+
+        /* Lanes whose message has already ended keep their state. Block
+           counts stay far below 2^31, so the signed compare is safe. */
+        active = _mm256_cmpgt_epi32(vblocks, _mm256_set1_epi32((int)blk));
+        for(i = 0; i < 8; ++i)
+        {
+            S[i] = _mm256_blendv_epi8(S[i], T[i], active);
+        }
+    }
+
+    /* Back to one digest per lane. */
+    {
+        const __m256i BSWAP = _mm256_set_epi8(
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        transpose8(S);
+        for(l = 0; l < lanes; ++l)
+        {
+            _mm256_storeu_si256((__m256i*)digests[l], _mm256_shuffle_epi8(S[l], BSWAP));
+        }
+    }
+}
+
+#endif /* SHA256_HW_ACCEL && x86 */
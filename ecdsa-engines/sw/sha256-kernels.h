@@ -0,0 +1,69 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Internal definitions shared by the SHA-256 compression kernels.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __SHA256_KERNELS_H
+#define __SHA256_KERNELS_H
+
+#include <stdint.h>
+#include "sha256.h"
+
+/* Round constants, shared with the accelerated kernels. */
+extern const uint32_t sha256_K[64];
+
+/* Portable C compression function (rolled or unrolled per SHA256_UNROLLED). */
+void sha256_compress_portable(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks);
+
+#if SHA256_HW_ACCEL
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Returns nonzero if the CPU implements the SHA and SSE4.1 extensions. */
+int sha256_shani_supported(void);
+void sha256_compress_shani(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks);
+
+/* Returns nonzero if the CPU and OS support AVX2. */
+int sha256_avx2_supported(void);
+/* Digest up to 8 messages at once, one per 32-bit lane. Unused lanes are masked. */
+void sha256_x8_avx2(const uint8_t* const msgs[], const uint32_t lens[],
+    uint8_t digests[][SHA256_DIGEST_SIZE], uint32_t lanes);
+#endif
+
+#if defined(__aarch64__)
+/* Returns nonzero if the CPU implements the ARMv8 SHA-256 instructions. */
+int sha256_armv8_supported(void);
+void sha256_compress_armv8(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks);
+#endif
+
+#endif /* SHA256_HW_ACCEL */
+
+#endif
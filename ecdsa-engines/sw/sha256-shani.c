@@ -0,0 +1,132 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    SHA-256 compression using the x86 SHA extensions (SHA-NI).
+*    Only built for x86 host targets (gateway, provisioning and bench tools).
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include "sha256-kernels.h"
+
+#if SHA256_HW_ACCEL && (defined(__x86_64__) || defined(__i386__))
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+int sha256_shani_supported(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3))
+    {
+        return 0;
+    }
+    if(__get_cpuid_max(0, 0) < 7)
+    {
+        return 0;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & bit_SHA) != 0;
+}
+
+/* Four rounds on message words M (already byte swapped), i is the round group. */
+#define QROUND(M, i) do { \
+    MSG = _mm_add_epi32((M), _mm_loadu_si128((const __m128i*)&sha256_K[4 * (i)])); \
+    STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG); \
+    MSG = _mm_shuffle_epi32(MSG, 0x0E); \
+    STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG); \
+    } while(0)
+
+/* M0 = W[i..i+3] from W[i-16..i-1] held in M0..M3. */
+#define SCHED(M0, M1, M2, M3) do { \
+    M0 = _mm_sha256msg1_epu32(M0, M1); \
+    M0 = _mm_add_epi32(M0, _mm_alignr_epi8(M3, M2, 4)); \
+    M0 = _mm_sha256msg2_epu32(M0, M3); \
+    } while(0)
+
+__attribute__((target("sha,sse4.1,ssse3")))
+void sha256_compress_shani(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i STATE0, STATE1, MSG, TMP;
+    __m128i MSG0, MSG1, MSG2, MSG3;
+    __m128i ABEF_SAVE, CDGH_SAVE;
+
+    /* The SHA instructions keep the state as ABEF / CDGH. */
+    TMP = _mm_loadu_si128((const __m128i*)&state[0]);
+    STATE1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    TMP = _mm_shuffle_epi32(TMP, 0xB1);          /* CDAB */
+    STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);    /* EFGH */
+    STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);    /* ABEF */
+    STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); /* CDGH */
+
+    while(nblocks--)
+    {
+        ABEF_SAVE = STATE0;
+        CDGH_SAVE = STATE1;
+
+        MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 0)), MASK);
+        MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 16)), MASK);
+        MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 32)), MASK);
+        MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 48)), MASK);
+        blocks += SHA256_BLOCK_SIZE;
+
+        QROUND(MSG0, 0);
+        QROUND(MSG1, 1);
+        QROUND(MSG2, 2);
+        QROUND(MSG3, 3);
+
+        SCHED(MSG0, MSG1, MSG2, MSG3); QROUND(MSG0, 4);
+        SCHED(MSG1, MSG2, MSG3, MSG0); QROUND(MSG1, 5);
+        SCHED(MSG2, MSG3, MSG0, MSG1); QROUND(MSG2, 6);
+        SCHED(MSG3, MSG0, MSG1, MSG2); QROUND(MSG3, 7);
+        SCHED(MSG0, MSG1, MSG2, MSG3); QROUND(MSG0, 8);
+        SCHED(MSG1, MSG2, MSG3, MSG0); QROUND(MSG1, 9);
+        SCHED(MSG2, MSG3, MSG0, MSG1); QROUND(MSG2, 10);
+        SCHED(MSG3, MSG0, MSG1, MSG2); QROUND(MSG3, 11);
+        SCHED(MSG0, MSG1, MSG2, MSG3); QROUND(MSG0, 12);
+        SCHED(MSG1, MSG2, MSG3, MSG0); QROUND(MSG1, 13);
+        SCHED(MSG2, MSG3, MSG0, MSG1); QROUND(MSG2, 14);
+        SCHED(MSG3, MSG0, MSG1, MSG2); QROUND(MSG3, 15);
+
+        STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+        STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+    }
+
+    TMP = _mm_shuffle_epi32(STATE0, 0x1B);       /* FEBA */
+    STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);    /* DCHG */
+    STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); /* DCBA */
+    STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);    /* ABEF */
+
+    _mm_storeu_si128((__m128i*)&state[0], STATE0);
+    _mm_storeu_si128((__m128i*)&state[4], STATE1);
+}
+
+#endif /* SHA256_HW_ACCEL && x86 */
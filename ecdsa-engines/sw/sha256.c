@@ -0,0 +1,400 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Streaming SHA-256 (FIPS 180-4) used to compute transaction signing digests.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "sha256.h"
+#include "sha256-kernels.h"
+
+const uint32_t sha256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+static const uint32_t H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+#define ROTR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)  (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define S0(x) (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define S1(x) (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define s0(x) (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define s1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SHA256_ALIGNED_LOAD 1
+#define load_be32_aligned(p) __builtin_bswap32(*(const uint32_t*)(p))
+#elif defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define SHA256_ALIGNED_LOAD 1
+#define load_be32_aligned(p) (*(const uint32_t*)(p))
+#else
+#define SHA256_ALIGNED_LOAD 0
+#endif
+
+static uint32_t load_be32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void store_be32(uint8_t* p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/* Load the 16 message words of a block. Blocks that start on a word boundary
+   (the context buffer, and most serializer output) use whole-word loads. */
+static void load_block(uint32_t W[16], const uint8_t* block)
+{
+    int i;
+#if SHA256_ALIGNED_LOAD
+    if(((uintptr_t)block & 3) == 0)
+    {
+        for(i = 0; i < 16; ++i)
+        {
+            W[i] = load_be32_aligned(block + 4 * i);
+        }
+        return;
+    }
+#endif
+    for(i = 0; i < 16; ++i)
+    {
+        W[i] = load_be32(block + 4 * i);
+    }
+}
+
+#if SHA256_UNROLLED
+
+/* Message schedule on a 16-word ring: W[i] is replaced by W[i+16]. */
+#define SCHED(i) (W[(i) & 15] += s1(W[((i) - 2) & 15]) + W[((i) - 7) & 15] + s0(W[((i) - 15) & 15]))
+
+#define ROUND(a, b, c, d, e, f, g, h, i, w) do { \
+    uint32_t t1 = h + S1(e) + CH(e, f, g) + sha256_K[i] + (w); \
+    d += t1; \
+    h = t1 + S0(a) + MAJ(a, b, c); \
+    } while(0)
+
+#define ROUND8(i, w0, w1, w2, w3, w4, w5, w6, w7) \
+    ROUND(a, b, c, d, e, f, g, h, (i) + 0, w0); \
+    ROUND(h, a, b, c, d, e, f, g, (i) + 1, w1); \
+    ROUND(g, h, a, b, c, d, e, f, (i) + 2, w2); \
+    ROUND(f, g, h, a, b, c, d, e, (i) + 3, w3); \
+    ROUND(e, f, g, h, a, b, c, d, (i) + 4, w4); \
+    ROUND(d, e, f, g, h, a, b, c, (i) + 5, w5); \
+    ROUND(c, d, e, f, g, h, a, b, (i) + 6, w6); \
+    ROUND(b, c, d, e, f, g, h, a, (i) + 7, w7)
+
+#define ROUND16_LOAD(i) \
+    ROUND8((i), W[0], W[1], W[2], W[3], W[4], W[5], W[6], W[7]); \
+    ROUND8((i) + 8, W[8], W[9], W[10], W[11], W[12], W[13], W[14], W[15])
+
+#define ROUND16_SCHED(i) \
+    ROUND8((i), SCHED((i) + 0), SCHED((i) + 1), SCHED((i) + 2), SCHED((i) + 3), \
+        SCHED((i) + 4), SCHED((i) + 5), SCHED((i) + 6), SCHED((i) + 7)); \
+    ROUND8((i) + 8, SCHED((i) + 8), SCHED((i) + 9), SCHED((i) + 10), SCHED((i) + 11), \
+        SCHED((i) + 12), SCHED((i) + 13), SCHED((i) + 14), SCHED((i) + 15))
+
+void sha256_compress_portable(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    uint32_t W[16];
+    uint32_t a, b, c, d, e, f, g, h;
+
+    while(nblocks--)
+    {
+        load_block(W, blocks);
+        blocks += SHA256_BLOCK_SIZE;
+
+        a = state[0]; b = state[1]; c = state[2]; d = state[3];
+        e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+        ROUND16_LOAD(0);
+        ROUND16_SCHED(16);
+        ROUND16_SCHED(32);
+        ROUND16_SCHED(48);
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#else /* SHA256_UNROLLED */
+
+void sha256_compress_portable(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    uint32_t W[16];
+    uint32_t v[8];
+    uint32_t t1, t2, w;
+    int i, j;
+
+    while(nblocks--)
+    {
+        load_block(W, blocks);
+        blocks += SHA256_BLOCK_SIZE;
+
+        for(j = 0; j < 8; ++j)
+        {
+            v[j] = state[j];
+        }
+
+        for(i = 0; i < 64; ++i)
+        {
+            if(i < 16)
+            {
+                w = W[i];
+            }
+            else
+            {
+                w = W[i & 15] += s1(W[(i - 2) & 15]) + W[(i - 7) & 15] + s0(W[(i - 15) & 15]);
+            }
+            t1 = v[7] + S1(v[4]) + CH(v[4], v[5], v[6]) + sha256_K[i] + w;
+            t2 = S0(v[0]) + MAJ(v[0], v[1], v[2]);
+            for(j = 7; j > 0; --j)
+            {
+                v[j] = v[j - 1];
+            }
+            v[4] += t1;
+            v[0] = t1 + t2;
+        }
+
+        for(j = 0; j < 8; ++j)
+        {
+            state[j] += v[j];
+        }
+    }
+}
+
+#endif /* SHA256_UNROLLED */
+
+#if SHA256_HW_ACCEL
+
+typedef void (*sha256_compress_fn)(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks);
+
+static void compress_select(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks);
+
+static sha256_compress_fn g_compress = &compress_select;
+static const char* g_kernel_name = "portable";
+#if defined(__x86_64__) || defined(__i386__)
+static int g_x8_avx2 = 0;
+#endif
+
+/* Probe the CPU once, on first use. Concurrent first calls from several
+   host threads all store the same result, so no locking is needed. */
+static void select_kernel(void)
+{
+    sha256_compress_fn l_compress = &sha256_compress_portable;
+    const char* l_name = "portable";
+
+#if defined(__x86_64__) || defined(__i386__)
+    if(sha256_shani_supported())
+    {
+        l_compress = &sha256_compress_shani;
+        l_name = "sha-ni";
+    }
+    else
+    {
+        /* One SHA-NI stream outruns eight AVX2 lanes, so the multi-buffer
+           path is only worth taking on CPUs without the SHA extensions. */
+        g_x8_avx2 = sha256_avx2_supported();
+    }
+#elif defined(__aarch64__)
+    if(sha256_armv8_supported())
+    {
+        l_compress = &sha256_compress_armv8;
+        l_name = "armv8-ce";
+    }
+#endif
+
+    g_kernel_name = l_name;
+    g_compress = l_compress;
+}
+
+static void compress_select(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    select_kernel();
+    g_compress(state, blocks, nblocks);
+}
+
+void sha256_compress(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    g_compress(state, blocks, nblocks);
+}
+
+const char* sha256_kernel_name(void)
+{
+    if(g_compress == &compress_select)
+    {
+        select_kernel();
+    }
+    return g_kernel_name;
+}
+
+#else /* SHA256_HW_ACCEL */
+
+void sha256_compress(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks)
+{
+    sha256_compress_portable(state, blocks, nblocks);
+}
+
+const char* sha256_kernel_name(void)
+{
+    return "portable";
+}
+
+#endif /* SHA256_HW_ACCEL */
+
+void sha256_init(sha256_ctx_t* ctx)
+{
+    memcpy(ctx->state, H0, sizeof(ctx->state));
+    ctx->count = 0;
+}
+
+void sha256_update(sha256_ctx_t* ctx, const uint8_t* data, uint32_t len)
+{
+    uint32_t used = (uint32_t)ctx->count & (SHA256_BLOCK_SIZE - 1);
+    uint32_t nblocks;
+
+    ctx->count += len;
+
+    /* Top up a partially filled block first. */
+    if(used)
+    {
+        uint32_t fill = SHA256_BLOCK_SIZE - used;
+        if(len < fill)
+        {
+            memcpy(ctx->buffer.b + used, data, len);
+            return;
+        }
+        memcpy(ctx->buffer.b + used, data, fill);
+        sha256_compress(ctx->state, ctx->buffer.b, 1);
+        data += fill;
+        len -= fill;
+    }
+
+    /* Compress whole blocks in place without staging them in the buffer. */
+    nblocks = len / SHA256_BLOCK_SIZE;
+    if(nblocks)
+    {
+        sha256_compress(ctx->state, data, nblocks);
+        data += nblocks * SHA256_BLOCK_SIZE;
+        len -= nblocks * SHA256_BLOCK_SIZE;
+    }
+
+    if(len)
+    {
+        memcpy(ctx->buffer.b, data, len);
+    }
+}
+
+void sha256_final(sha256_ctx_t* ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    uint32_t used = (uint32_t)ctx->count & (SHA256_BLOCK_SIZE - 1);
+    uint64_t bits = ctx->count << 3;
+    int i;
+
+    ctx->buffer.b[used++] = 0x80;
+    if(used > SHA256_BLOCK_SIZE - 8)
+    {
+        memset(ctx->buffer.b + used, 0, SHA256_BLOCK_SIZE - used);
+        sha256_compress(ctx->state, ctx->buffer.b, 1);
+        used = 0;
+    }
+    memset(ctx->buffer.b + used, 0, SHA256_BLOCK_SIZE - 8 - used);
+    store_be32(ctx->buffer.b + 56, (uint32_t)(bits >> 32));
+    store_be32(ctx->buffer.b + 60, (uint32_t)bits);
+    sha256_compress(ctx->state, ctx->buffer.b, 1);
+
+    for(i = 0; i < 8; ++i)
+    {
+        store_be32(digest + 4 * i, ctx->state[i]);
+    }
+}
+
+void sha256_save(const sha256_ctx_t* ctx, sha256_midstate_t* mid)
+{
+    memcpy(mid->state, ctx->state, sizeof(mid->state));
+    mid->count = ctx->count;
+    memcpy(mid->tail, ctx->buffer.b, (uint32_t)ctx->count & (SHA256_BLOCK_SIZE - 1));
+}
+
+void sha256_restore(sha256_ctx_t* ctx, const sha256_midstate_t* mid)
+{
+    memcpy(ctx->state, mid->state, sizeof(ctx->state));
+    ctx->count = mid->count;
+    memcpy(ctx->buffer.b, mid->tail, (uint32_t)mid->count & (SHA256_BLOCK_SIZE - 1));
+}
+
+void sha256(const uint8_t* data, uint32_t len, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    sha256_ctx_t ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, len);
+    sha256_final(&ctx, digest);
+}
+
+void sha256_x8(
+    const uint8_t* const msgs[],
+    const uint32_t lens[],
+    uint8_t digests[][SHA256_DIGEST_SIZE],
+    uint32_t n)
+{
+    uint32_t i = 0;
+
+#if SHA256_HW_ACCEL && (defined(__x86_64__) || defined(__i386__))
+    if(g_compress == &compress_select)
+    {
+        select_kernel();
+    }
+    if(g_x8_avx2)
+    {
+        for(; i < n; i += 8)
+        {
+            sha256_x8_avx2(msgs + i, lens + i, digests + i, (n - i < 8) ? n - i : 8);
+        }
+        return;
+    }
+#endif
+
+    for(; i < n; ++i)
+    {
+        sha256(msgs[i], lens[i], digests[i]);
+    }
+}
@@ -0,0 +1,143 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Streaming SHA-256 used to compute transaction signing digests.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __SHA256_H
+#define __SHA256_H
+
+#include <stdint.h>
+
+#define SHA256_BLOCK_SIZE   64
+#define SHA256_DIGEST_SIZE  32
+
+/* SHA256_UNROLLED - If enabled (defined as nonzero), the compression function is
+   fully unrolled. This is roughly twice as fast but costs about 2 KB more flash
+   than the compact rolled loop. Override with SHA256_CONF_UNROLLED. */
+#ifdef SHA256_CONF_UNROLLED
+#define SHA256_UNROLLED SHA256_CONF_UNROLLED
+#else
+#define SHA256_UNROLLED 1
+#endif
+
+/* SHA256_HW_ACCEL - If enabled (defined as nonzero), host builds for x86 and
+   AArch64 probe the CPU once and run SHA-NI or ARMv8 crypto extension
+   compression when available, falling back to the portable code otherwise.
+   It is enabled by default on those architectures and has no effect on the
+   MCU targets. Override with SHA256_CONF_HW_ACCEL. */
+#ifdef SHA256_CONF_HW_ACCEL
+#define SHA256_HW_ACCEL SHA256_CONF_HW_ACCEL
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+#define SHA256_HW_ACCEL 1
+#else
+#define SHA256_HW_ACCEL 0
+#endif
+
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t count;         /* total number of message bytes absorbed */
+    union {
+        uint8_t b[SHA256_BLOCK_SIZE];
+        uint32_t w[SHA256_BLOCK_SIZE / 4];  /* forces word alignment of the block buffer */
+    } buffer;
+} sha256_ctx_t;
+
+/* Saved hash state part way through a message, e.g. just after a constant
+   prefix. Only the unprocessed tail of the partial block is meaningful. */
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t count;
+    uint8_t tail[SHA256_BLOCK_SIZE];
+} sha256_midstate_t;
+
+/**
+ * Prepare a context for a new message.
+ */
+void sha256_init(sha256_ctx_t* ctx);
+
+/**
+ *  Absorb the next chunk of the message. May be called any number of times
+ *  with chunks of any size, e.g. as each field of a transaction is serialized.
+ *  Whole blocks are compressed straight from the caller's buffer.
+ */
+void sha256_update(sha256_ctx_t* ctx, const uint8_t* data, uint32_t len);
+
+/**
+ *  Pad the message and write out the digest. The context must be
+ *  re-initialized before it is used again.
+ */
+void sha256_final(sha256_ctx_t* ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ *  Snapshot the context so hashing can later resume from this point.
+ *  The context is left untouched and may continue to be updated.
+ */
+void sha256_save(const sha256_ctx_t* ctx, sha256_midstate_t* mid);
+
+/**
+ *  Load a snapshot into a context. Hashing continues as if the bytes absorbed
+ *  before sha256_save() had just been fed to it, without recompressing them.
+ */
+void sha256_restore(sha256_ctx_t* ctx, const sha256_midstate_t* mid);
+
+/**
+ *  One-shot digest of a contiguous message.
+ */
+void sha256(const uint8_t* data, uint32_t len, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ *  Run the compression function over nblocks consecutive 64-byte blocks.
+ */
+void sha256_compress(uint32_t state[8], const uint8_t* blocks, uint32_t nblocks);
+
+/**
+ *  Digest n independent messages of differing lengths, e.g. a batch of
+ *  signing digests, transaction IDs or Merkle leaves. On x86 hosts with AVX2
+ *  the messages are hashed eight at a time, one per SIMD lane, with lanes
+ *  masked off once their message is complete. Elsewhere each message goes
+ *  through sha256().
+ */
+void sha256_x8(
+    const uint8_t* const msgs[],
+    const uint32_t lens[],
+    uint8_t digests[][SHA256_DIGEST_SIZE],
+    uint32_t n);
+
+/**
+ *  Name of the compression kernel in use: "portable", "sha-ni" or "armv8-ce".
+ *  Mostly of interest to the benchmark tools.
+ */
+const char* sha256_kernel_name(void);
+
+#endif
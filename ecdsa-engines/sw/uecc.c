@@ -299,10 +299,44 @@ typedef struct EccPoint
     uECC_word_t y[uECC_WORDS];
 } EccPoint;
 
-static uECC_word_t curve_p[uECC_WORDS] = uECC_CONCAT(Curve_P_, uECC_CURVE);
-static uECC_word_t curve_b[uECC_WORDS] = uECC_CONCAT(Curve_B_, uECC_CURVE);
-static EccPoint curve_G = uECC_CONCAT(Curve_G_, uECC_CURVE);
-static uECC_word_t curve_n[uECC_N_WORDS] = uECC_CONCAT(Curve_N_, uECC_CURVE);
+/* Curves built into this image. With uECC_MULTI_CURVE both 256-bit curves are
+   available; otherwise only uECC_CURVE is. */
+#if (uECC_MULTI_CURVE && (uECC_CURVE == uECC_secp256k1 || uECC_CURVE == uECC_secp256r1))
+#define uECC_SUPPORTS_secp160r1 0
+#define uECC_SUPPORTS_secp192r1 0
+#define uECC_SUPPORTS_secp256r1 1
+#define uECC_SUPPORTS_secp256k1 1
+#else
+#define uECC_SUPPORTS_secp160r1 (uECC_CURVE == uECC_secp160r1)
+#define uECC_SUPPORTS_secp192r1 (uECC_CURVE == uECC_secp192r1)
+#define uECC_SUPPORTS_secp256r1 (uECC_CURVE == uECC_secp256r1)
+#define uECC_SUPPORTS_secp256k1 (uECC_CURVE == uECC_secp256k1)
+#endif
+
+/* Curve context: the curve parameters together with the reduction and point
+   doubling specialized for that curve. */
+struct uECC_Curve_t
+{
+    uECC_word_t p[uECC_WORDS];
+    uECC_word_t b[uECC_WORDS];
+    EccPoint G;
+    uECC_word_t n[uECC_N_WORDS];
+    uint8_t id; /* uECC_secp256k1, uECC_secp256r1, ... */
+    void (*mmod_fast)(uECC_word_t *RESTRICT p_result, uECC_word_t *RESTRICT p_product);
+    void (*double_jacobian)(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT Z1);
+    const EccPoint *comb_table; /* fixed-base table for G, or NULL */
+};
+
+/* The curve in use, see uECC_set_curve(). The curve instances are defined
+   below the arithmetic they point to. */
+static const struct uECC_Curve_t *g_curve;
+
+/* The vli routines take non-const operands but never write to the modulus,
+   so the curve constants can stay in flash. */
+#define curve_p ((uECC_word_t *)g_curve->p)
+#define curve_b ((uECC_word_t *)g_curve->b)
+#define curve_n ((uECC_word_t *)g_curve->n)
+#define curve_G (*(EccPoint *)&g_curve->G)
 
 static void vli_clear(uECC_word_t *p_vli);
 static uECC_word_t vli_isZero(const uECC_word_t *p_vli);
@@ -316,7 +350,7 @@ static uECC_word_t vli_sub(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word
 static void vli_mult(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right);
 static void vli_modAdd(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right, uECC_word_t *p_mod);
 static void vli_modSub(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right, uECC_word_t *p_mod);
-static void vli_mmod_fast(uECC_word_t *RESTRICT p_result, uECC_word_t *RESTRICT p_product);
+#define vli_mmod_fast(result, product) g_curve->mmod_fast((result), (product))
 static void vli_modMult_fast(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right);
 static void vli_modInv(uECC_word_t *p_result, uECC_word_t *p_input, uECC_word_t *p_mod);
 #if uECC_SQUARE_FUNC
@@ -407,11 +441,38 @@ static int default_RNG(uint8_t *p_dest, unsigned p_size)
 // Functions to set the callbacks for crypto operations
 static uECC_RNG_Function g_rng = &default_RNG;
 
+#if uECC_PROFILE
+static uECC_Counters g_counters;
+
+void uECC_get_counters(uECC_Counters *p_counters)
+{
+    *p_counters = g_counters;
+}
+
+#define uECC_COUNT(counter) ((void)++g_counters.counter)
+#define uECC_COUNT_START() ((void)(g_counters = (uECC_Counters){0}))
+#else
+#define uECC_COUNT(counter) ((void)0)
+#define uECC_COUNT_START() ((void)0)
+#endif
+
+#define uECC_RNG(p_dest, p_size) (uECC_COUNT(rng), g_rng((p_dest), (p_size)))
+
 void uECC_set_rng(uECC_RNG_Function p_rng)
 {
     g_rng = p_rng;
 }
 
+uECC_RNG_Function uECC_get_rng(void)
+{
+    return g_rng;
+}
+
+unsigned uECC_word_size(void)
+{
+    return uECC_WORD_SIZE;
+}
+
 static uECC_make_key_Function g_make_key_cb = &uECC_make_key_impl;
 
 void uECC_set_make_key_cb(uECC_make_key_Function p_make_key_cb)
@@ -625,7 +686,7 @@ static uECC_word_t vli_sub(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word
 }
 #endif
 
-#if (!asm_mult || !asm_square || uECC_CURVE == uECC_secp256k1)
+#if (!asm_mult || !asm_square || uECC_SUPPORTS_secp256k1)
 static void muladd(uECC_word_t a, uECC_word_t b, uECC_word_t *r0, uECC_word_t *r1, uECC_word_t *r2)
 {
 #if uECC_WORD_SIZE == 8 && !SUPPORTS_INT128
@@ -822,7 +883,7 @@ static void vli_modSub(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *
 
 #if !asm_mmod_fast
 
-#if (uECC_CURVE == uECC_secp160r1 || uECC_CURVE == uECC_secp256k1)
+#if (uECC_SUPPORTS_secp160r1 || uECC_SUPPORTS_secp256k1)
 /* omega_mult() is defined farther below for the different curves / word sizes */
 static void omega_mult(uECC_word_t * RESTRICT p_result, uECC_word_t * RESTRICT p_right);
 
@@ -830,7 +891,7 @@ static void omega_mult(uECC_word_t * RESTRICT p_result, uECC_word_t * RESTRICT p
     see http://www.isys.uni-klu.ac.at/PDF/2001-0126-MT.pdf page 354
 
     Note that this only works if log2(omega) < log2(p)/2 */
-static void vli_mmod_fast(uECC_word_t *RESTRICT p_result, uECC_word_t *RESTRICT p_product)
+static void vli_mmod_omega(uECC_word_t *RESTRICT p_result, uECC_word_t *RESTRICT p_product)
 {
     uECC_word_t l_tmp[2*uECC_WORDS];
     uECC_word_t l_carry;
@@ -859,7 +920,7 @@ static void vli_mmod_fast(uECC_word_t *RESTRICT p_result, uECC_word_t *RESTRICT
 
 #endif
 
-#if uECC_CURVE == uECC_secp160r1
+#if uECC_SUPPORTS_secp160r1
 
 #if uECC_WORD_SIZE == 1
 static void omega_mult(uint8_t * RESTRICT p_result, uint8_t * RESTRICT p_right)
@@ -901,12 +962,14 @@ static void omega_mult(uint32_t * RESTRICT p_result, uint32_t * RESTRICT p_right
 }
 #endif /* uECC_WORD_SIZE */
 
-#elif uECC_CURVE == uECC_secp192r1
+#endif /* uECC_SUPPORTS_secp160r1 */
+
+#if uECC_SUPPORTS_secp192r1
 
 /* Computes p_result = p_product % curve_p.
    See algorithm 5 and 6 from http://www.isys.uni-klu.ac.at/PDF/2001-0126-MT.pdf */
 #if uECC_WORD_SIZE == 1
-static void vli_mmod_fast(uint8_t *RESTRICT p_result, uint8_t *RESTRICT p_product)
+static void vli_mmod_fast_secp192r1(uint8_t *RESTRICT p_result, uint8_t *RESTRICT p_product)
 {
     uint8_t l_tmp[uECC_WORDS];
     uint8_t l_carry;
@@ -940,7 +1003,7 @@ static void vli_mmod_fast(uint8_t *RESTRICT p_result, uint8_t *RESTRICT p_produc
     }
 }
 #elif uECC_WORD_SIZE == 4
-static void vli_mmod_fast(uint32_t *RESTRICT p_result, uint32_t *RESTRICT p_product)
+static void vli_mmod_fast_secp192r1(uint32_t *RESTRICT p_result, uint32_t *RESTRICT p_product)
 {
     uint32_t l_tmp[uECC_WORDS];
     int l_carry;
@@ -968,7 +1031,7 @@ static void vli_mmod_fast(uint32_t *RESTRICT p_result, uint32_t *RESTRICT p_prod
     }
 }
 #else
-static void vli_mmod_fast(uint64_t *RESTRICT p_result, uint64_t *RESTRICT p_product)
+static void vli_mmod_fast_secp192r1(uint64_t *RESTRICT p_result, uint64_t *RESTRICT p_product)
 {
     uint64_t l_tmp[uECC_WORDS];
     int l_carry;
@@ -994,12 +1057,14 @@ static void vli_mmod_fast(uint64_t *RESTRICT p_result, uint64_t *RESTRICT p_prod
 }
 #endif /* uECC_WORD_SIZE */
 
-#elif uECC_CURVE == uECC_secp256r1
+#endif /* uECC_SUPPORTS_secp192r1 */
+
+#if uECC_SUPPORTS_secp256r1
 
 /* Computes p_result = p_product % curve_p
    from http://www.nsa.gov/ia/_files/nist-routines.pdf */
 #if uECC_WORD_SIZE == 1
-static void vli_mmod_fast(uint8_t *RESTRICT p_result, uint8_t *RESTRICT p_product)
+static void vli_mmod_fast_secp256r1(uint8_t *RESTRICT p_result, uint8_t *RESTRICT p_product)
 {
     uint8_t l_tmp[uECC_BYTES];
     int8_t l_carry;
@@ -1110,7 +1175,7 @@ static void vli_mmod_fast(uint8_t *RESTRICT p_result, uint8_t *RESTRICT p_produc
     }
 }
 #elif uECC_WORD_SIZE == 4
-static void vli_mmod_fast(uint32_t *RESTRICT p_result, uint32_t *RESTRICT p_product)
+static void vli_mmod_fast_secp256r1(uint32_t *RESTRICT p_result, uint32_t *RESTRICT p_product)
 {
     uint32_t l_tmp[uECC_WORDS];
     int l_carry;
@@ -1214,7 +1279,7 @@ static void vli_mmod_fast(uint32_t *RESTRICT p_result, uint32_t *RESTRICT p_prod
     }
 }
 #else
-static void vli_mmod_fast(uint64_t *RESTRICT p_result, uint64_t *RESTRICT p_product)
+static void vli_mmod_fast_secp256r1(uint64_t *RESTRICT p_result, uint64_t *RESTRICT p_product)
 {
     uint64_t l_tmp[uECC_WORDS];
     int l_carry;
@@ -1296,7 +1361,9 @@ static void vli_mmod_fast(uint64_t *RESTRICT p_result, uint64_t *RESTRICT p_prod
 }
 #endif /* uECC_WORD_SIZE */
 
-#elif uECC_CURVE == uECC_secp256k1
+#endif /* uECC_SUPPORTS_secp256r1 */
+
+#if uECC_SUPPORTS_secp256k1
 
 #if uECC_WORD_SIZE == 1
 static void omega_mult(uint8_t * RESTRICT p_result, uint8_t * RESTRICT p_right)
@@ -1371,12 +1438,13 @@ static void omega_mult(uint64_t * RESTRICT p_result, uint64_t * RESTRICT p_right
 }
 #endif /* uECC_WORD_SIZE */
 
-#endif /* uECC_CURVE */
+#endif /* uECC_SUPPORTS_secp256k1 */
 #endif /* !asm_mmod_fast */
 
 /* Computes p_result = (p_left * p_right) % curve_p. */
 static void vli_modMult_fast(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right)
 {
+    uECC_COUNT(modMult);
     uECC_word_t l_product[2 * uECC_WORDS];
     vli_mult(l_product, p_left, p_right);
     vli_mmod_fast(p_result, l_product);
@@ -1387,6 +1455,7 @@ static void vli_modMult_fast(uECC_word_t *p_result, uECC_word_t *p_left, uECC_wo
 /* Computes p_result = p_left^2 % curve_p. */
 static void vli_modSquare_fast(uECC_word_t *p_result, uECC_word_t *p_left)
 {
+    uECC_COUNT(modSquare);
     uECC_word_t l_product[2 * uECC_WORDS];
     vli_square(l_product, p_left);
     vli_mmod_fast(p_result, l_product);
@@ -1406,6 +1475,7 @@ static void vli_modSquare_fast(uECC_word_t *p_result, uECC_word_t *p_left)
 #if !asm_modInv
 static void vli_modInv(uECC_word_t *p_result, uECC_word_t *p_input, uECC_word_t *p_mod)
 {
+    uECC_COUNT(modInv);
     uECC_word_t a[uECC_WORDS], b[uECC_WORDS], u[uECC_WORDS], v[uECC_WORDS];
     uECC_word_t l_carry;
     cmpresult_t l_cmpResult;
@@ -1502,13 +1572,45 @@ static cmpresult_t EccPoint_isZero(EccPoint *p_point)
     return (vli_isZero(p_point->x) && vli_isZero(p_point->y));
 }
 
+/* Returns 1 if p_point is a point on the curve other than infinity, 0 otherwise.
+   Points received from a peer must pass this check before they are multiplied
+   with a private key. */
+static uECC_word_t EccPoint_isValid(EccPoint *p_point)
+{
+    uECC_word_t l_tmp1[uECC_WORDS];
+    uECC_word_t l_tmp2[uECC_WORDS];
+
+    if(EccPoint_isZero(p_point))
+    {
+        return 0;
+    }
+
+    /* x and y must be smaller than p. */
+    if(vli_cmp(curve_p, p_point->x) != 1 || vli_cmp(curve_p, p_point->y) != 1)
+    {
+        return 0;
+    }
+
+    vli_modSquare_fast(l_tmp1, p_point->y); /* tmp1 = y^2 */
+    vli_modSquare_fast(l_tmp2, p_point->x); /* tmp2 = x^2 */
+    if(g_curve->id != uECC_secp256k1)
+    {
+        uECC_word_t _3[uECC_WORDS] = {3}; /* -a = 3 */
+        vli_modSub_fast(l_tmp2, l_tmp2, _3); /* tmp2 = x^2 - 3 */
+    }
+    vli_modMult_fast(l_tmp2, l_tmp2, p_point->x); /* tmp2 = x^3 + ax */
+    vli_modAdd(l_tmp2, l_tmp2, curve_b, curve_p); /* tmp2 = x^3 + ax + b */
+
+    return (vli_cmp(l_tmp1, l_tmp2) == 0);
+}
+
 /* Point multiplication algorithm using Montgomery's ladder with co-Z coordinates.
 From http://eprint.iacr.org/2011/338.pdf
 */
 
 /* Double in place */
-#if (uECC_CURVE == uECC_secp256k1)
-static void EccPoint_double_jacobian(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT Z1)
+#if uECC_SUPPORTS_secp256k1
+static void EccPoint_double_jacobian_secp256k1(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT Z1)
 {
     /* t1 = X, t2 = Y, t3 = Z */
     uECC_word_t t4[uECC_WORDS];
@@ -1547,8 +1649,11 @@ static void EccPoint_double_jacobian(uECC_word_t * RESTRICT X1, uECC_word_t * RE
     vli_modMult_fast(Y1, Y1, t4);    /* t2 = B * (A - x3) */
     vli_modSub(Y1, Y1, t5, curve_p); /* t2 = B * (A - x3) - y1^4 = y3 */
 }
-#else
-static void EccPoint_double_jacobian(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT Z1)
+#endif
+
+/* Double in place, for the curves with a = -3 */
+#if (uECC_SUPPORTS_secp160r1 || uECC_SUPPORTS_secp192r1 || uECC_SUPPORTS_secp256r1)
+static void EccPoint_double_jacobian_a3(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT Z1)
 {
     /* t1 = X, t2 = Y, t3 = Z */
     uECC_word_t t4[uECC_WORDS];
@@ -1597,6 +1702,8 @@ static void EccPoint_double_jacobian(uECC_word_t * RESTRICT X1, uECC_word_t * RE
 }
 #endif
 
+#define EccPoint_double_jacobian(X1, Y1, Z1) (uECC_COUNT(double_jacobian), g_curve->double_jacobian((X1), (Y1), (Z1)))
+
 /* Modify (x1, y1) => (x1 * z^2, y1 * z^3) */
 static void apply_z(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT Z)
 {
@@ -1637,6 +1744,7 @@ static void XYcZ_initial_double(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRIC
 */
 static void XYcZ_add(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT X2, uECC_word_t * RESTRICT Y2)
 {
+    uECC_COUNT(XYcZ_add);
     /* t1 = X1, t2 = Y1, t3 = X2, t4 = Y2 */
     uECC_word_t t5[uECC_WORDS];
 
@@ -1664,6 +1772,7 @@ static void XYcZ_add(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_
 */
 static void XYcZ_addC(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1, uECC_word_t * RESTRICT X2, uECC_word_t * RESTRICT Y2)
 {
+    uECC_COUNT(XYcZ_add);
     /* t1 = X1, t2 = Y1, t3 = X2, t4 = Y2 */
     uECC_word_t t5[uECC_WORDS];
     uECC_word_t t6[uECC_WORDS];
@@ -1759,6 +1868,328 @@ static void mod_sqrt(uECC_word_t *a)
     vli_set(a, l_result);
 }
 
+/* ------ Fixed-base multiplication ------ */
+
+/* k*G for a fixed generator uses a precomputed comb with 4 teeth spaced
+   64 bits apart, so a 256-bit scalar costs 64 doublings and 64 mixed
+   additions instead of a full 256-step ladder. The table is 15 affine
+   points (960 bytes of flash) and is only provided for the 256-bit curves. */
+#if (uECC_SUPPORTS_secp256k1 || uECC_SUPPORTS_secp256r1)
+
+#define uECC_COMB_TEETH   4
+#define uECC_COMB_SPACING (uECC_BYTES * 8 / uECC_COMB_TEETH)
+#define uECC_COMB_SIZE    ((1 << uECC_COMB_TEETH) - 1)
+
+/* Table words are given as pairs of 32-bit halves, least significant first. */
+#if (uECC_WORD_SIZE == 1)
+#define COMB_W(lo, hi) \
+    (uint8_t)(lo), (uint8_t)((lo) >> 8), (uint8_t)((lo) >> 16), (uint8_t)((lo) >> 24), \
+    (uint8_t)(hi), (uint8_t)((hi) >> 8), (uint8_t)((hi) >> 16), (uint8_t)((hi) >> 24)
+#elif (uECC_WORD_SIZE == 4)
+#define COMB_W(lo, hi) (lo), (hi)
+#else
+#define COMB_W(lo, hi) (((uint64_t)(hi) << 32) | (lo))
+#endif
+
+/* comb_table[b - 1] = sum of 2^(64*j) * G for each bit j set in b. */
+#if uECC_SUPPORTS_secp256k1
+static const EccPoint comb_table_secp256k1[uECC_COMB_SIZE] = {
+    {{COMB_W(0x16F81798, 0x59F2815B), COMB_W(0x2DCE28D9, 0x029BFCDB), COMB_W(0xCE870B07, 0x55A06295), COMB_W(0xF9DCBBAC, 0x79BE667E)},
+     {COMB_W(0xFB10D4B8, 0x9C47D08F), COMB_W(0xA6855419, 0xFD17B448), COMB_W(0x0E1108A8, 0x5DA4FBFC), COMB_W(0x26A3C465, 0x483ADA77)}},
+    {{COMB_W(0x42D0E6BD, 0x13B7E0E7), COMB_W(0xDB0F5E53, 0xF774D163), COMB_W(0x104D6ECB, 0x82A2147C), COMB_W(0x243C4E25, 0x3322D401)},
+     {COMB_W(0x6C28B2A0, 0x24F3A2E9), COMB_W(0xA2873AF6, 0x2805F63E), COMB_W(0x4DDAF9B7, 0xBFB019BC), COMB_W(0xE9664EF5, 0x56E70797)}},
+    {{COMB_W(0x829D122A, 0xDCA81127), COMB_W(0x67E99549, 0x8F17F314), COMB_W(0x6A8A9E73, 0x9B889085), COMB_W(0x846DD99D, 0x583FDFD9)},
+     {COMB_W(0x63C4EAC4, 0xF3C7719E), COMB_W(0xB734B37A, 0xB44685A3), COMB_W(0x572A47A6, 0x9F92D2D6), COMB_W(0x2FF57D81, 0xABC6232F)}},
+    {{COMB_W(0x9EC4C0DA, 0x1B7B444C), COMB_W(0x723EA335, 0xE88C5678), COMB_W(0x981F162E, 0x9239C1AD), COMB_W(0xF63B5F33, 0x8F68B9D2)},
+     {COMB_W(0x501FFF82, 0xF23CBF79), COMB_W(0x95510BFD, 0xBBEA2CFE), COMB_W(0xB6BE215D, 0xDE1D90C2), COMB_W(0xBA063986, 0x662A9F2D)}},
+    {{COMB_W(0x114CBF09, 0x63C5E885), COMB_W(0x7BE77E3E, 0x2F27CE93), COMB_W(0xF54A3E33, 0xDAA6D12D), COMB_W(0x3EFF872C, 0x8B300E51)},
+     {COMB_W(0xB3B10A39, 0x26C6FF28), COMB_W(0x9AAF7169, 0x08F6A7AA), COMB_W(0x6B8238EA, 0x446F0D46), COMB_W(0x7F43C0CC, 0x1CEC3067)}},
+    {{COMB_W(0x075E9070, 0xBA16CE6A), COMB_W(0x9B5CFE37, 0xBC26893D), COMB_W(0x9C510774, 0xE1DDADFE), COMB_W(0xFE3AE2F4, 0x90922D88)},
+     {COMB_W(0x5C08824A, 0x653943CC), COMB_W(0xFCE8F4BC, 0x06D74475), COMB_W(0x533C615D, 0x8D101FA7), COMB_W(0x742108A9, 0x7B1903F6)}},
+    {{COMB_W(0x6EBDC96C, 0x1BCFA45C), COMB_W(0x1C7584BA, 0xE400BC04), COMB_W(0x74CF531F, 0x6395E20E), COMB_W(0xC5131B30, 0x1EDD0BB1)},
+     {COMB_W(0xE358CF9E, 0xA117161B), COMB_W(0x2724D11C, 0xE490D6F0), COMB_W(0xEE6DD8C9, 0xF75062F6), COMB_W(0xFBA373E4, 0x31E03B2B)}},
+    {{COMB_W(0x2120E2B3, 0x7F3B58FA), COMB_W(0x7F47F9AA, 0x7A58FDCE), COMB_W(0x4CE6E521, 0xE7BE4AE3), COMB_W(0x1F51BDBA, 0xEAA649F2)},
+     {COMB_W(0xBA5AD93D, 0xD47A5305), COMB_W(0xF13F7E59, 0x01A6B965), COMB_W(0x9879AA5A, 0xC69A80F8), COMB_W(0x5BBBB03A, 0xBE3279ED)}},
+    {{COMB_W(0x27BB4D71, 0xCF291A33), COMB_W(0x33524832, 0x6CAF7D6B), COMB_W(0x766584EE, 0x6E0EE131), COMB_W(0xD064C589, 0x160CB0F6)},
+     {COMB_W(0x17136E8D, 0x9D5DE554), COMB_W(0x1AAB720E, 0xE3F2D468), COMB_W(0xCCF75CC2, 0xD1378B49), COMB_W(0xC4FF16E1, 0x6920C375)}},
+    {{COMB_W(0x1A9EE611, 0x3EEF9E96), COMB_W(0x9CC37FAF, 0xFE4D7BF3), COMB_W(0xB321D965, 0x462AA9B3), COMB_W(0x208736C5, 0x1702DA3E)},
+     {COMB_W(0x3A545CEB, 0xFBA57BBF), COMB_W(0x7EA858F5, 0x6DBCD766), COMB_W(0x680D92F1, 0x088E897C), COMB_W(0xBC626C80, 0x468C1FD8)}},
+    {{COMB_W(0xB188660A, 0xB40F85C7), COMB_W(0x99BC3C36, 0xC5873C19), COMB_W(0x7F33B54C, 0x3C7B4541), COMB_W(0x1F8C9BF8, 0x4CD3A93C)},
+     {COMB_W(0x33099CB0, 0xF8DCE380), COMB_W(0x2EDD2F33, 0x7A167DD6), COMB_W(0x0FFE35B7, 0x576D8987), COMB_W(0xC68ACE5C, 0xD2DE0386)}},
+    {{COMB_W(0x6658BB08, 0x9A9E0A72), COMB_W(0xC589607B, 0xE23C5F2A), COMB_W(0xF2BFB4C8, 0xA048CA14), COMB_W(0xC62C2291, 0x4D9A0F89)},
+     {COMB_W(0x0F827294, 0x427B5F31), COMB_W(0x9F2C35CD, 0x1EA7A8B5), COMB_W(0x85A3C00F, 0x95442E56), COMB_W(0x9B57975A, 0x8CB83121)}},
+    {{COMB_W(0x51F5CF67, 0x4333F0DA), COMB_W(0xF4F0D3CB, 0x6D3EA47C), COMB_W(0xA05A831F, 0x442FDA14), COMB_W(0x016D3E81, 0x6A496013)},
+     {COMB_W(0xE52E0F48, 0xF647318C), COMB_W(0x4A0D5FF1, 0x5FF3A66E), COMB_W(0x61199BA8, 0x046ED81A), COMB_W(0x3E79C23A, 0x578EDF08)}},
+    {{COMB_W(0x3EA01EA7, 0xB8F996F8), COMB_W(0x7497BB15, 0xC0045D33), COMB_W(0x6205647C, 0xC4749DC9), COMB_W(0x0EFD22C9, 0xD8946054)},
+     {COMB_W(0x12774AD5, 0x062DCB09), COMB_W(0x8BE06E3A, 0xCB13F310), COMB_W(0x235DE1A9, 0xCA281D35), COMB_W(0x69C3645C, 0xAF8A7412)}},
+    {{COMB_W(0xBEB8B1E2, 0x8808CA5F), COMB_W(0xEA0DDA76, 0x0262B204), COMB_W(0xDDEB356B, 0xB6FFFFFC), COMB_W(0xFBB83870, 0x52DE253A)},
+     {COMB_W(0x8F8D21EA, 0x961F40C0), COMB_W(0x002F03ED, 0x89686278), COMB_W(0x38E421EA, 0x0FF834D7), COMB_W(0xD36FB8DB, 0x3A270D6F)}}
+};
+#endif
+
+#if uECC_SUPPORTS_secp256r1
+static const EccPoint comb_table_secp256r1[uECC_COMB_SIZE] = {
+    {{COMB_W(0xD898C296, 0xF4A13945), COMB_W(0x2DEB33A0, 0x77037D81), COMB_W(0x63A440F2, 0xF8BCE6E5), COMB_W(0xE12C4247, 0x6B17D1F2)},
+     {COMB_W(0x37BF51F5, 0xCBB64068), COMB_W(0x6B315ECE, 0x2BCE3357), COMB_W(0x7C0F9E16, 0x8EE7EB4A), COMB_W(0xFE1A7F9B, 0x4FE342E2)}},
+    {{COMB_W(0x8E14DB63, 0x90E75CB4), COMB_W(0xAD651F7E, 0x29493BAA), COMB_W(0x326E25DE, 0x8492592E), COMB_W(0x2811AAA5, 0x0FA822BC)},
+     {COMB_W(0x5F462EE7, 0xE4112454), COMB_W(0x50FE82F5, 0x34B1A650), COMB_W(0xB3DF188B, 0x6F4AD4BC), COMB_W(0xF5DBA80D, 0xBFF44AE8)}},
+    {{COMB_W(0x097992AF, 0x93391CE2), COMB_W(0x0D35F1FA, 0xE96C98FD), COMB_W(0x95E02789, 0xB257C0DE), COMB_W(0x89D6726F, 0x300A4BBC)},
+     {COMB_W(0xC08127A0, 0xAA54A291), COMB_W(0xA9D806A5, 0x5BB1EEAD), COMB_W(0xFF1E3C6F, 0x7F1DDB25), COMB_W(0xD09B4644, 0x72AAC7E0)}},
+    {{COMB_W(0xD789BD85, 0x57C84FC9), COMB_W(0xC297EAC3, 0xFC35FF7D), COMB_W(0x88C6766E, 0xFB982FD5), COMB_W(0xEEDB5E67, 0x447D739B)},
+     {COMB_W(0x72E25B32, 0x0C7E33C9), COMB_W(0xA7FAE500, 0x3D349B95), COMB_W(0x3A4AAFF7, 0xE12E9D95), COMB_W(0x834131EE, 0x2D4825AB)}},
+    {{COMB_W(0x2A1D367F, 0x13949C93), COMB_W(0x1A0A11B7, 0xEF7FBD2B), COMB_W(0xB91DFC60, 0xDDC6068B), COMB_W(0x8A9C72FF, 0xEF951932)},
+     {COMB_W(0x7376D8A8, 0x196035A7), COMB_W(0x95CA1740, 0x23183B08), COMB_W(0x022C219C, 0xC1EE9807), COMB_W(0x7DBB2C9B, 0x611E9FC3)}},
+    {{COMB_W(0x0B57F4BC, 0xCAE2B192), COMB_W(0xC6C9BC36, 0x2936DF5E), COMB_W(0xE11238BF, 0x7DEA6482), COMB_W(0x7B51F5D8, 0x55066379)},
+     {COMB_W(0x348A964C, 0x44FFE216), COMB_W(0xDBDEFBE1, 0x9FB3D576), COMB_W(0x8D9D50E5, 0x0AFA4001), COMB_W(0x8AECB851, 0x15716484)}},
+    {{COMB_W(0xFC5CDE01, 0xE48ECAFF), COMB_W(0x0D715F26, 0x7CCD84E7), COMB_W(0xF43E4391, 0xA2E8F483), COMB_W(0xB21141EA, 0xEB5D7745)},
+     {COMB_W(0x731A3479, 0xCAC917E2), COMB_W(0x2844B645, 0x85F22CFE), COMB_W(0x58006CEE, 0x0990E6A1), COMB_W(0xDBECC17B, 0xEAFD72EB)}},
+    {{COMB_W(0x313728BE, 0x6CF20FFB), COMB_W(0xA3C6B94A, 0x96439591), COMB_W(0x44315FC5, 0x2736FF83), COMB_W(0xA7849276, 0xA6D39677)},
+     {COMB_W(0xC357F5F4, 0xF2BAB833), COMB_W(0x2284059B, 0x824A920C), COMB_W(0x2D27ECDF, 0x66B8BABD), COMB_W(0x9B0B8816, 0x674F8474)}},
+    {{COMB_W(0x677C8A3E, 0x2DF48C04), COMB_W(0x0203A56B, 0x74E02F08), COMB_W(0xB8C7FEDB, 0x31855F7D), COMB_W(0x72C9DDAD, 0x4E769E76)},
+     {COMB_W(0xB824BBB0, 0xA4C36165), COMB_W(0x3B9122A5, 0xFB9AE16F), COMB_W(0x06947281, 0x1EC00572), COMB_W(0xDE830663, 0x42B99082)}},
+    {{COMB_W(0xDDA868B9, 0x6EF95150), COMB_W(0x9C0CE131, 0xD1F89E79), COMB_W(0x08A1C478, 0x7FDC1CA0), COMB_W(0x1C6CE04D, 0x78878EF6)},
+     {COMB_W(0x1FE0D976, 0x9C62B912), COMB_W(0xBDE08D4F, 0x6ACE570E), COMB_W(0x12309DEF, 0xDE53142C), COMB_W(0x7B72C321, 0xB6CB3F5D)}},
+    {{COMB_W(0xC31A3573, 0x7F991ED2), COMB_W(0xD54FB496, 0x5B82DD5B), COMB_W(0x812FFCAE, 0x595C5220), COMB_W(0x716B1287, 0x0C88BC4D)},
+     {COMB_W(0x5F48ACA8, 0x3A57BF63), COMB_W(0xDF2564F3, 0x7C8181F4), COMB_W(0x9C04E6AA, 0x18D1B5B3), COMB_W(0xF3901DC6, 0xDD5DDEA3)}},
+    {{COMB_W(0x3E72AD0C, 0xE96A79FB), COMB_W(0x42BA792F, 0x43A0A28C), COMB_W(0x083E49F3, 0xEFE0A423), COMB_W(0x6B317466, 0x68F344AF)},
+     {COMB_W(0x3FB24D4A, 0xCDFE17DB), COMB_W(0x71F5C626, 0x668BFC22), COMB_W(0x24D67FF3, 0x604ED93C), COMB_W(0xF8540A20, 0x31B9C405)}},
+    {{COMB_W(0xA2582E7F, 0xD36B4789), COMB_W(0x4EC39C28, 0x0D1A1014), COMB_W(0xEDBAD7A0, 0x663C62C3), COMB_W(0x6F461DB9, 0x4052BF4B)},
+     {COMB_W(0x188D25EB, 0x235A27C3), COMB_W(0x99BFCC5B, 0xE724F339), COMB_W(0x71D70CC8, 0x862BE6BD), COMB_W(0x90B0FC61, 0xFECF4D51)}},
+    {{COMB_W(0xA1D4CFAC, 0x74346C10), COMB_W(0x8526A7A4, 0xAFDF5CC0), COMB_W(0xF62BFF7A, 0x123202A8), COMB_W(0xC802E41A, 0x1EDDBAE2)},
+     {COMB_W(0xD603F844, 0x8FA0AF2D), COMB_W(0x4C701917, 0x36E06B7E), COMB_W(0x73DB33A0, 0x0C45F452), COMB_W(0x560EBCFC, 0x43104D86)}},
+    {{COMB_W(0x0D1D78E5, 0x9615B511), COMB_W(0x25C4744B, 0x66B0DE32), COMB_W(0x6AAF363A, 0x0A4A46FB), COMB_W(0x84F7A21C, 0xB48E26B4)},
+     {COMB_W(0x21A01B2D, 0x06EBB0F6), COMB_W(0x8B7B0F98, 0xC004E404), COMB_W(0xFED6F668, 0x64131BCD), COMB_W(0x4D4D3DAB, 0xFAC01540)}}
+};
+#endif
+
+#undef COMB_W
+
+/* Constant-time lookup of the curve's comb_table[p_index - 1]. Every entry is read so the
+   memory access pattern does not depend on the scalar. Index 0 yields (0, 0). */
+static void comb_select(EccPoint *p_point, uECC_word_t p_index)
+{
+    wordcount_t i, j;
+
+    vli_clear(p_point->x);
+    vli_clear(p_point->y);
+    for(i = 0; i < uECC_COMB_SIZE; ++i)
+    {
+        uECC_word_t l_mask = (uECC_word_t)0 - (uECC_word_t)(p_index == (uECC_word_t)(i + 1));
+        for(j = 0; j < uECC_WORDS; ++j)
+        {
+            p_point->x[j] |= g_curve->comb_table[i].x[j] & l_mask;
+            p_point->y[j] |= g_curve->comb_table[i].y[j] & l_mask;
+        }
+    }
+}
+
+/* Copy p_src over p_dest if p_cond is 1, without branching on p_cond. */
+static void vli_cmov(uECC_word_t *p_dest, const uECC_word_t *p_src, uECC_word_t p_cond)
+{
+    uECC_word_t l_mask = (uECC_word_t)0 - p_cond;
+    wordcount_t i;
+    for(i = 0; i < uECC_WORDS; ++i)
+    {
+        p_dest[i] ^= (p_dest[i] ^ p_src[i]) & l_mask;
+    }
+}
+
+/* Mixed addition (X1, Y1, Z1) + (x2, y2, 1) => (X3, Y3, Z3).
+   Falls back to doubling if the points are equal. */
+static void EccPoint_add_affine(uECC_word_t * RESTRICT X1, uECC_word_t * RESTRICT Y1,
+    uECC_word_t * RESTRICT Z1, EccPoint * RESTRICT p_point)
+{
+    uECC_word_t t1[uECC_WORDS];
+    uECC_word_t t2[uECC_WORDS];
+    uECC_word_t t3[uECC_WORDS];
+    uECC_word_t t4[uECC_WORDS];
+
+    vli_modSquare_fast(t1, Z1);            /* t1 = z1^2 */
+    vli_modMult_fast(t2, p_point->x, t1);  /* t2 = x2*z1^2 = U2 */
+    vli_modMult_fast(t1, t1, Z1);          /* t1 = z1^3 */
+    vli_modMult_fast(t1, p_point->y, t1);  /* t1 = y2*z1^3 = S2 */
+    vli_modSub_fast(t2, t2, X1);           /* t2 = U2 - x1 = H */
+    vli_modSub_fast(t1, t1, Y1);           /* t1 = S2 - y1 = R */
+
+    if(vli_isZero(t2))
+    {
+        if(vli_isZero(t1))
+        { /* P == Q */
+            vli_set(X1, p_point->x);
+            vli_set(Y1, p_point->y);
+            vli_clear(Z1);
+            Z1[0] = 1;
+            EccPoint_double_jacobian(X1, Y1, Z1);
+        }
+        else
+        { /* P == -Q */
+            vli_clear(Z1);
+        }
+        return;
+    }
+
+    vli_modMult_fast(Z1, Z1, t2);          /* z3 = z1*H */
+    vli_modSquare_fast(t3, t2);            /* t3 = H^2 */
+    vli_modMult_fast(t4, t2, t3);          /* t4 = H^3 */
+    vli_modMult_fast(t3, X1, t3);          /* t3 = x1*H^2 = V */
+    vli_modSquare_fast(X1, t1);            /* x3 = R^2 */
+    vli_modSub_fast(X1, X1, t4);           /* x3 = R^2 - H^3 */
+    vli_modSub_fast(X1, X1, t3);
+    vli_modSub_fast(X1, X1, t3);           /* x3 = R^2 - H^3 - 2V */
+    vli_modSub_fast(t3, t3, X1);           /* t3 = V - x3 */
+    vli_modMult_fast(t3, t1, t3);          /* t3 = R*(V - x3) */
+    vli_modMult_fast(t4, Y1, t4);          /* t4 = y1*H^3 */
+    vli_modSub_fast(Y1, t3, t4);           /* y3 = R*(V - x3) - y1*H^3 */
+}
+
+/* Fixed-base multiplication state, so the comb can be run a few columns at a
+   time by the resumable signing API.
+
+   The accumulator starts at G rather than at infinity, so every column does
+   the same doubling and addition whatever the leading digits of the scalar
+   are. After the comb's doublings the offset has become 2^SPACING * G, which
+   is comb_table[1] and is subtracted again at the end. */
+typedef struct
+{
+    uECC_word_t X[uECC_WORDS];
+    uECC_word_t Y[uECC_WORDS];
+    uECC_word_t Z[uECC_WORDS];
+    bitcount_t column;      /* next comb column, -1 when done */
+} MultG_state;
+
+static void EccPoint_mult_G_start(MultG_state *p_state)
+{
+    vli_set(p_state->X, curve_G.x);
+    vli_set(p_state->Y, curve_G.y);
+    vli_clear(p_state->Z);
+    p_state->Z[0] = 1;
+    p_state->column = uECC_COMB_SPACING - 1;
+}
+
+/* Process up to p_columns comb columns. Returns nonzero once all are done. */
+static uECC_word_t EccPoint_mult_G_run(MultG_state *p_state, const uECC_word_t *p_scalar, unsigned p_columns)
+{
+    uECC_word_t *X = p_state->X;
+    uECC_word_t *Y = p_state->Y;
+    uECC_word_t *Z = p_state->Z;
+    uECC_word_t tx[uECC_WORDS];
+    uECC_word_t ty[uECC_WORDS];
+    uECC_word_t tz[uECC_WORDS];
+    EccPoint l_point;
+    uECC_word_t l_index;
+    bitcount_t i;
+    wordcount_t j;
+
+    for(; p_state->column >= 0 && p_columns; --p_state->column, --p_columns)
+    {
+        i = p_state->column;
+        EccPoint_double_jacobian(X, Y, Z);
+
+        l_index = 0;
+        for(j = 0; j < uECC_COMB_TEETH; ++j)
+        {
+            l_index |= (uECC_word_t)(!!vli_testBit(p_scalar, i + j * uECC_COMB_SPACING)) << j;
+        }
+        comb_select(&l_point, l_index);
+
+        vli_set(tx, X);
+        vli_set(ty, Y);
+        vli_set(tz, Z);
+        EccPoint_add_affine(tx, ty, tz, &l_point);
+
+        /* Keep the sum for a nonzero digit. */
+        vli_cmov(X, tx, (l_index != 0));
+        vli_cmov(Y, ty, (l_index != 0));
+        vli_cmov(Z, tz, (l_index != 0));
+    }
+
+    return (p_state->column < 0);
+}
+
+static void EccPoint_mult_G_finish(MultG_state *p_state, EccPoint * RESTRICT p_result)
+{
+    EccPoint l_offset;
+    uECC_word_t l_one[uECC_WORDS] = {1};
+    uECC_word_t l_infinity = vli_isZero(p_state->Z);
+
+    /* Remove the starting offset: add -(2^SPACING * G). If the sum is already
+       the point at infinity, which only happens for p_scalar*G = -offset,
+       the result is the negated offset itself. */
+    vli_set(l_offset.x, g_curve->comb_table[1].x);
+    vli_sub(l_offset.y, curve_p, (uECC_word_t *)g_curve->comb_table[1].y);
+    EccPoint_add_affine(p_state->X, p_state->Y, p_state->Z, &l_offset);
+    vli_cmov(p_state->X, l_offset.x, l_infinity);
+    vli_cmov(p_state->Y, l_offset.y, l_infinity);
+    vli_cmov(p_state->Z, l_one, l_infinity);
+
+    if(vli_isZero(p_state->Z))
+    {
+        vli_clear(p_result->x);
+        vli_clear(p_result->y);
+        return;
+    }
+
+    vli_modInv(p_state->Z, p_state->Z, curve_p);
+    apply_z(p_state->X, p_state->Y, p_state->Z);
+    vli_set(p_result->x, p_state->X);
+    vli_set(p_result->y, p_state->Y);
+}
+
+/* p_result = p_scalar * G. The running time does not depend on p_scalar except
+   in the negligible case where an intermediate sum meets a table point or the
+   final offset. */
+static void EccPoint_mult_G(EccPoint * RESTRICT p_result, const uECC_word_t * RESTRICT p_scalar)
+{
+    MultG_state l_state;
+
+    EccPoint_mult_G_start(&l_state);
+    EccPoint_mult_G_run(&l_state, p_scalar, uECC_COMB_SPACING);
+    EccPoint_mult_G_finish(&l_state, p_result);
+}
+
+#else
+
+/* The resumable callers are not built for secp160r1. */
+#if (uECC_CURVE != uECC_secp160r1)
+
+typedef struct
+{
+    EccPoint result;
+    uECC_word_t done;
+} MultG_state;
+
+static void EccPoint_mult_G_start(MultG_state *p_state)
+{
+    p_state->done = 0;
+}
+
+/* Without a comb table the multiplication is done in one go. */
+static uECC_word_t EccPoint_mult_G_run(MultG_state *p_state, const uECC_word_t *p_scalar, unsigned p_columns)
+{
+    (void)p_columns;
+    if(!p_state->done)
+    {
+        EccPoint_mult(&p_state->result, &curve_G, p_scalar, 0, vli_numBits(p_scalar, uECC_WORDS));
+        p_state->done = 1;
+    }
+    return 1;
+}
+
+static void EccPoint_mult_G_finish(MultG_state *p_state, EccPoint * RESTRICT p_result)
+{
+    vli_set(p_result->x, p_state->result.x);
+    vli_set(p_result->y, p_state->result.y);
+}
+
+#endif /* (uECC_CURVE != uECC_secp160r1) */
+
+static void EccPoint_mult_G(EccPoint * RESTRICT p_result, const uECC_word_t * RESTRICT p_scalar)
+{
+    EccPoint_mult(p_result, &curve_G, p_scalar, 0, vli_numBits(p_scalar, uECC_WORDS));
+}
+
+#endif /* uECC_CURVE */
+
 #if uECC_WORD_SIZE == 1
 
 static void vli_nativeToBytes(uint8_t * RESTRICT p_dest, const uint8_t * RESTRICT p_src)
@@ -1829,9 +2260,79 @@ static void vli_bytesToNative(uint64_t *p_native, const uint8_t *p_bytes)
 
 #endif /* uECC_WORD_SIZE */
 
+/* ------ Curve contexts ------ */
+
+#if uECC_SUPPORTS_secp160r1
+static const struct uECC_Curve_t curve_secp160r1 = {
+    Curve_P_1, Curve_B_1, Curve_G_1, Curve_N_1, uECC_secp160r1,
+    &vli_mmod_omega, &EccPoint_double_jacobian_a3, NULL };
+#endif
+
+#if uECC_SUPPORTS_secp192r1
+static const struct uECC_Curve_t curve_secp192r1 = {
+    Curve_P_2, Curve_B_2, Curve_G_2, Curve_N_2, uECC_secp192r1,
+    &vli_mmod_fast_secp192r1, &EccPoint_double_jacobian_a3, NULL };
+#endif
+
+#if uECC_SUPPORTS_secp256r1
+static const struct uECC_Curve_t curve_secp256r1 = {
+    Curve_P_3, Curve_B_3, Curve_G_3, Curve_N_3, uECC_secp256r1,
+    &vli_mmod_fast_secp256r1, &EccPoint_double_jacobian_a3, comb_table_secp256r1 };
+#endif
+
+#if uECC_SUPPORTS_secp256k1
+static const struct uECC_Curve_t curve_secp256k1 = {
+    Curve_P_4, Curve_B_4, Curve_G_4, Curve_N_4, uECC_secp256k1,
+    &vli_mmod_omega, &EccPoint_double_jacobian_secp256k1, comb_table_secp256k1 };
+#endif
+
+#if (uECC_CURVE == uECC_secp160r1)
+static const struct uECC_Curve_t *g_curve = &curve_secp160r1;
+#elif (uECC_CURVE == uECC_secp192r1)
+static const struct uECC_Curve_t *g_curve = &curve_secp192r1;
+#elif (uECC_CURVE == uECC_secp256r1)
+static const struct uECC_Curve_t *g_curve = &curve_secp256r1;
+#else
+static const struct uECC_Curve_t *g_curve = &curve_secp256k1;
+#endif
+
+uECC_Curve uECC_get_curve(void)
+{
+    return g_curve;
+}
+
+int uECC_set_curve(uECC_Curve p_curve)
+{
+    if(p_curve == NULL)
+    {
+        return 0;
+    }
+    g_curve = p_curve;
+    return 1;
+}
+
+uECC_Curve uECC_curve_secp256k1(void)
+{
+#if uECC_SUPPORTS_secp256k1
+    return &curve_secp256k1;
+#else
+    return NULL;
+#endif
+}
+
+uECC_Curve uECC_curve_secp256r1(void)
+{
+#if uECC_SUPPORTS_secp256r1
+    return &curve_secp256r1;
+#else
+    return NULL;
+#endif
+}
+
 // Safe calls to the callback functions
 int uECC_make_key(uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[uECC_BYTES])
 {
+    uECC_COUNT_START();
     // Check for a valid function pointer
     if (g_make_key_cb != NULL)
     {
@@ -1845,6 +2346,7 @@ int uECC_make_key(uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[uECC_B
 
 int uECC_shared_secret(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_privateKey[uECC_BYTES], uint8_t p_secret[uECC_BYTES])
 {
+    uECC_COUNT_START();
     // Check for a valid function pointer
     if (g_shared_secret_cb != NULL)
     {
@@ -1858,6 +2360,7 @@ int uECC_shared_secret(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_
 
 int uECC_sign(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2])
 {
+    uECC_COUNT_START();
     // Check for a valid function pointer
     if (g_sign_cb != NULL)
     {
@@ -1871,6 +2374,7 @@ int uECC_sign(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_
 
 int uECC_verify(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
 {
+	uECC_COUNT_START();
 	// Check for a valid function pointer
 	if (g_verify_cb != NULL)
 	{
@@ -1884,6 +2388,7 @@ int uECC_verify(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uE
 
 int uECC_ecdhe(const uint8_t p_public_key_in[uECC_BYTES*2], uint8_t p_public_key_out[uECC_BYTES*2], uint8_t p_secret[uECC_BYTES])
 {
+	uECC_COUNT_START();
 	// Check for a valid function pointer
 	if (g_ecdhe_cb != NULL)
 	{
@@ -1897,6 +2402,7 @@ int uECC_ecdhe(const uint8_t p_public_key_in[uECC_BYTES*2], uint8_t p_public_key
 
 int uECC_get_pubkey(const uint8_t p_key_handle[uECC_BYTES], uint8_t p_public_key[uECC_BYTES*2])
 {
+	uECC_COUNT_START();
 	// Check for a valid function pointer
 	if (g_get_pubkey_cb != NULL)
 	{
@@ -1908,14 +2414,54 @@ int uECC_get_pubkey(const uint8_t p_key_handle[uECC_BYTES], uint8_t p_public_key
 	}
 }
 
+/* Ephemeral-static ECDH: a fresh key pair is made for each call and its
+   private half is wiped before returning. */
 int uECC_ecdhe_impl(const uint8_t p_public_key_in[uECC_BYTES*2], uint8_t p_public_key_out[uECC_BYTES*2], uint8_t p_secret[uECC_BYTES])
 {
-	return 0;
+    uint8_t l_private[uECC_BYTES];
+    volatile uint8_t *l_wipe = l_private;
+    wordcount_t i;
+    int l_result;
+
+    if(!uECC_make_key_impl(p_public_key_out, l_private))
+    {
+        return 0;
+    }
+
+    l_result = uECC_shared_secret_impl(p_public_key_in, l_private, p_secret);
+
+    for(i = 0; i < uECC_BYTES; ++i)
+    {
+        l_wipe[i] = 0;
+    }
+    return l_result;
 }
 
+/* The software engine has no key store: the handle is the private key itself. */
 int uECC_get_pubkey_impl(const uint8_t p_key_handle[uECC_BYTES], uint8_t p_public_key[uECC_BYTES*2])
 {
-	return 0;
+    EccPoint l_public;
+    uECC_word_t l_private[uECC_WORDS];
+
+    vli_bytesToNative(l_private, p_key_handle);
+
+    /* Make sure the private key is in the range [1, n-1]. */
+    if(vli_isZero(l_private))
+    {
+        return 0;
+    }
+#if uECC_CURVE != uECC_secp160r1
+    if(vli_cmp(curve_n, l_private) != 1)
+    {
+        return 0;
+    }
+#endif
+
+    EccPoint_mult_G(&l_public, l_private);
+
+    vli_nativeToBytes(p_public_key, l_public.x);
+    vli_nativeToBytes(p_public_key + uECC_BYTES, l_public.y);
+    return !EccPoint_isZero(&l_public);
 }
 
 int uECC_make_key_impl(uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[uECC_BYTES])
@@ -1927,7 +2473,7 @@ int uECC_make_key_impl(uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[u
     do
     {
     repeat:
-        if(!g_rng((uint8_t *)l_private, sizeof(l_private)) || (l_tries++ >= MAX_TRIES))
+        if(!uECC_RNG((uint8_t *)l_private, sizeof(l_private)) || (l_tries++ >= MAX_TRIES))
         {
             return 0;
         }
@@ -1944,7 +2490,7 @@ int uECC_make_key_impl(uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[u
         }
     #endif
 
-        EccPoint_mult(&l_public, &curve_G, l_private, 0, vli_numBits(l_private, uECC_WORDS));
+        EccPoint_mult_G(&l_public, l_private);
     } while(EccPoint_isZero(&l_public));
 
     vli_nativeToBytes(p_privateKey, l_private);
@@ -1953,26 +2499,39 @@ int uECC_make_key_impl(uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[u
     return 1;
 }
 
-int uECC_shared_secret_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_privateKey[uECC_BYTES], uint8_t p_secret[uECC_BYTES])
+/* ECDH with a public key that has already been checked. */
+static int shared_secret_point(EccPoint *p_public, const uint8_t p_privateKey[uECC_BYTES], uint8_t p_secret[uECC_BYTES])
 {
-    EccPoint l_public;
     uECC_word_t l_private[uECC_WORDS];
     uECC_word_t l_random[uECC_WORDS];
 
-    g_rng((uint8_t *)l_random, sizeof(l_random));
+    uECC_RNG((uint8_t *)l_random, sizeof(l_random));
 
     vli_bytesToNative(l_private, p_privateKey);
-    vli_bytesToNative(l_public.x, p_publicKey);
-    vli_bytesToNative(l_public.y, p_publicKey + uECC_BYTES);
 
     EccPoint l_product;
-    EccPoint_mult(&l_product, &l_public, l_private, (vli_isZero(l_random) ? 0: l_random), vli_numBits(l_private, uECC_WORDS));
+    EccPoint_mult(&l_product, p_public, l_private, (vli_isZero(l_random) ? 0: l_random), vli_numBits(l_private, uECC_WORDS));
 
     vli_nativeToBytes(p_secret, l_product.x);
 
     return !EccPoint_isZero(&l_product);
 }
 
+int uECC_shared_secret_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_privateKey[uECC_BYTES], uint8_t p_secret[uECC_BYTES])
+{
+    EccPoint l_public;
+
+    vli_bytesToNative(l_public.x, p_publicKey);
+    vli_bytesToNative(l_public.y, p_publicKey + uECC_BYTES);
+
+    if(!EccPoint_isValid(&l_public))
+    {
+        return 0;
+    }
+
+    return shared_secret_point(&l_public, p_privateKey, p_secret);
+}
+
 void uECC_compress(const uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_compressed[uECC_BYTES+1])
 {
     wordcount_t i;
@@ -1983,23 +2542,29 @@ void uECC_compress(const uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_compressed
     p_compressed[0] = 2 + (p_publicKey[uECC_BYTES * 2 - 1] & 0x01);
 }
 
-void uECC_decompress(const uint8_t p_compressed[uECC_BYTES+1], uint8_t p_publicKey[uECC_BYTES*2])
+/* Solve for y given x and its parity. The result is only a point on the curve if
+   x was a valid x coordinate; callers that need to know check with EccPoint_isValid(). */
+static void point_decompress(EccPoint *p_point, const uint8_t p_compressed[uECC_BYTES+1])
 {
     EccPoint l_point;
+
     vli_bytesToNative(l_point.x, p_compressed + 1);
 
-#if (uECC_CURVE == uECC_secp256k1)
-    vli_modSquare_fast(l_point.y, l_point.x); /* r = x^2 */
-    vli_modMult_fast(l_point.y, l_point.y, l_point.x); /* r = x^3 */
-    vli_modAdd(l_point.y, l_point.y, curve_b, curve_p); /* r = x^3 + b */
-#else
-    uECC_word_t _3[uECC_WORDS] = {3}; /* -a = 3 */
+    if(g_curve->id == uECC_secp256k1)
+    {
+        vli_modSquare_fast(l_point.y, l_point.x); /* r = x^2 */
+        vli_modMult_fast(l_point.y, l_point.y, l_point.x); /* r = x^3 */
+        vli_modAdd(l_point.y, l_point.y, curve_b, curve_p); /* r = x^3 + b */
+    }
+    else
+    {
+        uECC_word_t _3[uECC_WORDS] = {3}; /* -a = 3 */
 
-    vli_modSquare_fast(l_point.y, l_point.x); /* y = x^2 */
-    vli_modSub_fast(l_point.y, l_point.y, _3); /* y = x^2 - 3 */
-    vli_modMult_fast(l_point.y, l_point.y, l_point.x); /* y = x^3 - 3x */
-    vli_modAdd(l_point.y, l_point.y, curve_b, curve_p); /* y = x^3 - 3x + b */
-#endif
+        vli_modSquare_fast(l_point.y, l_point.x); /* y = x^2 */
+        vli_modSub_fast(l_point.y, l_point.y, _3); /* y = x^2 - 3 */
+        vli_modMult_fast(l_point.y, l_point.y, l_point.x); /* y = x^3 - 3x */
+        vli_modAdd(l_point.y, l_point.y, curve_b, curve_p); /* y = x^3 - 3x + b */
+    }
 
     mod_sqrt(l_point.y);
 
@@ -2008,45 +2573,220 @@ void uECC_decompress(const uint8_t p_compressed[uECC_BYTES+1], uint8_t p_publicK
         vli_sub(l_point.y, curve_p, l_point.y);
     }
 
+    vli_set(p_point->x, l_point.x);
+    vli_set(p_point->y, l_point.y);
+}
+
+void uECC_decompress(const uint8_t p_compressed[uECC_BYTES+1], uint8_t p_publicKey[uECC_BYTES*2])
+{
+    EccPoint l_point;
+
+    point_decompress(&l_point, p_compressed);
+
     vli_nativeToBytes(p_publicKey, l_point.x);
     vli_nativeToBytes(p_publicKey + uECC_BYTES, l_point.y);
 }
 
-/* -------- ECDSA code -------- */
+/* -------- Key handles -------- */
 
-#if (uECC_CURVE == uECC_secp160r1)
-static void vli_clear_n(uECC_word_t *p_vli)
+#define KEY_VALID   0x01
+#define KEY_PRIVATE 0x02
+
+typedef struct
 {
-    vli_clear(p_vli);
-    p_vli[uECC_N_WORDS - 1] = 0;
-}
+    EccPoint point;
+    uECC_word_t d[uECC_N_WORDS];    /* private key, KEY_PRIVATE handles only */
+    const struct uECC_Curve_t *curve;
+    uint8_t flags;
+} Key_handle;
 
-static uECC_word_t vli_isZero_n(const uECC_word_t *p_vli)
+typedef char uECC_key_size_check[(sizeof(Key_handle) <= sizeof(uECC_Key)) ? 1 : -1];
+
+/* The handle if it has all of p_flags and belongs to the current curve, else 0. */
+static const Key_handle *key_get(const uECC_Key *p_key, uint8_t p_flags)
 {
-    if(p_vli[uECC_N_WORDS - 1])
+    const Key_handle *l_key = (const Key_handle *)p_key;
+
+    if((l_key->flags & p_flags) != p_flags || l_key->curve != g_curve)
     {
         return 0;
     }
-    return vli_isZero(p_vli);
+    return l_key;
 }
 
-static void vli_set_n(uECC_word_t *p_dest, const uECC_word_t *p_src)
+void uECC_key_wipe(uECC_Key *p_key)
 {
-    vli_set(p_dest, p_src);
-    p_dest[uECC_N_WORDS-1] = p_src[uECC_N_WORDS-1];
+    volatile uint8_t *l_wipe = (volatile uint8_t *)p_key;
+    unsigned i;
+
+    for(i = 0; i < sizeof(uECC_Key); ++i)
+    {
+        l_wipe[i] = 0;
+    }
 }
 
-static cmpresult_t vli_cmp_n(uECC_word_t *p_left, uECC_word_t *p_right)
+int uECC_key_load(uECC_Key *p_key, const uint8_t *p_publicKey, unsigned p_size)
 {
-    if(p_left[uECC_N_WORDS-1] > p_right[uECC_N_WORDS-1])
+    Key_handle *l_key = (Key_handle *)p_key;
+
+    uECC_COUNT_START();
+    uECC_key_wipe(p_key);
+
+    if(p_size == uECC_BYTES * 2)
     {
-        return 1;
+        vli_bytesToNative(l_key->point.x, p_publicKey);
+        vli_bytesToNative(l_key->point.y, p_publicKey + uECC_BYTES);
     }
-    else if(p_left[uECC_N_WORDS-1] < p_right[uECC_N_WORDS-1])
+    else if(p_size == uECC_BYTES + 1 && (p_publicKey[0] == 2 || p_publicKey[0] == 3))
     {
-        return -1;
+        point_decompress(&l_key->point, p_publicKey);
     }
-    return vli_cmp(p_left, p_right);
+    else
+    {
+        return 0;
+    }
+
+    /* Also rejects an x with no square root, for which decompression gives garbage. */
+    if(!EccPoint_isValid(&l_key->point))
+    {
+        return 0;
+    }
+
+    l_key->curve = g_curve;
+    l_key->flags = KEY_VALID;
+    return 1;
+}
+
+int uECC_key_load_private(uECC_Key *p_key, const uint8_t p_privateKey[uECC_BYTES])
+{
+    Key_handle *l_key = (Key_handle *)p_key;
+
+    uECC_COUNT_START();
+    uECC_key_wipe(p_key);
+
+    vli_bytesToNative(l_key->d, p_privateKey);
+
+    /* Make sure the private key is in the range [1, n-1]. */
+    if(vli_isZero(l_key->d))
+    {
+        return 0;
+    }
+#if uECC_CURVE != uECC_secp160r1
+    if(vli_cmp(curve_n, l_key->d) != 1)
+    {
+        uECC_key_wipe(p_key);
+        return 0;
+    }
+#endif
+
+    EccPoint_mult_G(&l_key->point, l_key->d);
+    if(EccPoint_isZero(&l_key->point))
+    {
+        uECC_key_wipe(p_key);
+        return 0;
+    }
+
+    l_key->curve = g_curve;
+    l_key->flags = KEY_VALID | KEY_PRIVATE;
+    return 1;
+}
+
+int uECC_key_valid(const uECC_Key *p_key)
+{
+    return key_get(p_key, KEY_VALID) != 0;
+}
+
+int uECC_key_export(const uECC_Key *p_key, uint8_t p_publicKey[uECC_BYTES*2])
+{
+    const Key_handle *l_key = key_get(p_key, KEY_VALID);
+
+    if(!l_key)
+    {
+        return 0;
+    }
+
+    vli_nativeToBytes(p_publicKey, l_key->point.x);
+    vli_nativeToBytes(p_publicKey + uECC_BYTES, l_key->point.y);
+    return 1;
+}
+
+int uECC_shared_secret_key(const uECC_Key *p_key, const uint8_t p_privateKey[uECC_BYTES], uint8_t p_secret[uECC_BYTES])
+{
+    const Key_handle *l_key = key_get(p_key, KEY_VALID);
+    EccPoint l_public;
+
+    uECC_COUNT_START();
+    if(!l_key)
+    {
+        return 0;
+    }
+
+    vli_set(l_public.x, l_key->point.x);
+    vli_set(l_public.y, l_key->point.y);
+    return shared_secret_point(&l_public, p_privateKey, p_secret);
+}
+
+int uECC_ecdhe_key(const uECC_Key *p_key, uint8_t p_public_key_out[uECC_BYTES*2], uint8_t p_secret[uECC_BYTES])
+{
+    const Key_handle *l_key = key_get(p_key, KEY_VALID);
+    EccPoint l_public;
+    uint8_t l_private[uECC_BYTES];
+    volatile uint8_t *l_wipe = l_private;
+    wordcount_t i;
+    int l_result;
+
+    uECC_COUNT_START();
+    if(!l_key || !uECC_make_key_impl(p_public_key_out, l_private))
+    {
+        return 0;
+    }
+
+    vli_set(l_public.x, l_key->point.x);
+    vli_set(l_public.y, l_key->point.y);
+    l_result = shared_secret_point(&l_public, l_private, p_secret);
+
+    for(i = 0; i < uECC_BYTES; ++i)
+    {
+        l_wipe[i] = 0;
+    }
+    return l_result;
+}
+
+/* -------- ECDSA code -------- */
+
+#if (uECC_CURVE == uECC_secp160r1)
+static void vli_clear_n(uECC_word_t *p_vli)
+{
+    vli_clear(p_vli);
+    p_vli[uECC_N_WORDS - 1] = 0;
+}
+
+static uECC_word_t vli_isZero_n(const uECC_word_t *p_vli)
+{
+    if(p_vli[uECC_N_WORDS - 1])
+    {
+        return 0;
+    }
+    return vli_isZero(p_vli);
+}
+
+static void vli_set_n(uECC_word_t *p_dest, const uECC_word_t *p_src)
+{
+    vli_set(p_dest, p_src);
+    p_dest[uECC_N_WORDS-1] = p_src[uECC_N_WORDS-1];
+}
+
+static cmpresult_t vli_cmp_n(uECC_word_t *p_left, uECC_word_t *p_right)
+{
+    if(p_left[uECC_N_WORDS-1] > p_right[uECC_N_WORDS-1])
+    {
+        return 1;
+    }
+    else if(p_left[uECC_N_WORDS-1] < p_right[uECC_N_WORDS-1])
+    {
+        return -1;
+    }
+    return vli_cmp(p_left, p_right);
 }
 
 static void vli_rshift1_n(uECC_word_t *p_vli)
@@ -2128,6 +2868,7 @@ static void vli_modAdd_n(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t
 
 static void vli_modInv_n(uECC_word_t *p_result, uECC_word_t *p_input, uECC_word_t *p_mod)
 {
+    uECC_COUNT(modInv);
     uECC_word_t a[uECC_N_WORDS], b[uECC_N_WORDS], u[uECC_N_WORDS], v[uECC_N_WORDS];
     uECC_word_t l_carry;
     cmpresult_t l_cmpResult;
@@ -2211,6 +2952,7 @@ static uECC_word_t vli2_sub_n(uECC_word_t *p_result, uECC_word_t *p_left, uECC_w
 /* Computes p_result = (p_left * p_right) % curve_n. */
 static void vli_modMult_n(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right)
 {
+    uECC_COUNT(modMult_n);
     uECC_word_t l_product[2 * uECC_N_WORDS];
     uECC_word_t l_modMultiple[2 * uECC_N_WORDS];
     uECC_word_t l_tmp[2 * uECC_N_WORDS];
@@ -2266,6 +3008,7 @@ static uECC_word_t vli2_sub(uECC_word_t *p_result, uECC_word_t *p_left, uECC_wor
 /* Computes p_result = (p_left * p_right) % curve_n. */
 static void vli_modMult_n(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_t *p_right)
 {
+    uECC_COUNT(modMult_n);
     uECC_word_t l_product[2 * uECC_WORDS];
     uECC_word_t l_modMultiple[2 * uECC_WORDS];
     uECC_word_t l_tmp[2 * uECC_WORDS];
@@ -2288,7 +3031,8 @@ static void vli_modMult_n(uECC_word_t *p_result, uECC_word_t *p_left, uECC_word_
 }
 #endif /* (uECC_CURVE != uECC_secp160r1) */
 
-int uECC_sign_impl(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2])
+/* Sign with a private key already in native format. */
+static int sign_native(const uECC_word_t *p_private, const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2])
 {
     uECC_word_t k[uECC_N_WORDS];
     uECC_word_t l_tmp[uECC_N_WORDS];
@@ -2300,7 +3044,7 @@ int uECC_sign_impl(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[
     do
     {
     repeat:
-        if(!g_rng((uint8_t *)k, sizeof(k)) || (l_tries++ >= MAX_TRIES))
+        if(!uECC_RNG((uint8_t *)k, sizeof(k)) || (l_tries++ >= MAX_TRIES))
         {
             return 0;
         }
@@ -2348,7 +3092,7 @@ int uECC_sign_impl(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[
     l_tries = 0;
     do
     {
-        if(!g_rng((uint8_t *)l_tmp, sizeof(l_tmp)) || (l_tries++ >= MAX_TRIES))
+        if(!uECC_RNG((uint8_t *)l_tmp, sizeof(l_tmp)) || (l_tries++ >= MAX_TRIES))
         {
             return 0;
         }
@@ -2363,7 +3107,7 @@ int uECC_sign_impl(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[
     vli_nativeToBytes(p_signature, p.x); /* store r */
 
     l_tmp[uECC_N_WORDS-1] = 0;
-    vli_bytesToNative(l_tmp, p_privateKey); /* tmp = d */
+    vli_set(l_tmp, p_private); /* tmp = d */
     s[uECC_N_WORDS-1] = 0;
     vli_set(s, p.x);
     vli_modMult_n(s, l_tmp, s); /* s = r*d */
@@ -2382,28 +3126,61 @@ int uECC_sign_impl(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[
     return 1;
 }
 
+int uECC_sign_impl(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2])
+{
+    uECC_word_t l_private[uECC_N_WORDS];
+
+    vli_bytesToNative(l_private, p_privateKey);
+    return sign_native(l_private, p_hash, p_signature);
+}
+
+int uECC_sign_key(const uECC_Key *p_key, const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2])
+{
+    const Key_handle *l_key = key_get(p_key, KEY_VALID | KEY_PRIVATE);
+
+    uECC_COUNT_START();
+    if(!l_key)
+    {
+        return 0;
+    }
+    return sign_native(l_key->d, p_hash, p_signature);
+}
+
 static bitcount_t smax(bitcount_t a, bitcount_t b)
 {
     return (a > b ? a : b);
 }
 
-int uECC_verify_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
+/* Verification state between the setup, the Shamir's trick loop and the
+   final comparison, so the loop can be run a few bits at a time. */
+typedef struct
 {
-    uECC_word_t u1[uECC_N_WORDS], u2[uECC_N_WORDS];
-    uECC_word_t z[uECC_N_WORDS];
-    EccPoint l_public, l_sum;
+    uECC_word_t u1[uECC_N_WORDS];
+    uECC_word_t u2[uECC_N_WORDS];
+    EccPoint l_public;
+    EccPoint l_sum;
     uECC_word_t rx[uECC_WORDS];
     uECC_word_t ry[uECC_WORDS];
-    uECC_word_t tx[uECC_WORDS];
-    uECC_word_t ty[uECC_WORDS];
-    uECC_word_t tz[uECC_WORDS];
+    uECC_word_t z[uECC_WORDS];
+    uECC_word_t r[uECC_N_WORDS];
+    bitcount_t bit;         /* next bit of u1/u2, -1 when done */
+} Verify_state;
+
+static void shamir_start(Verify_state *p_state);
+
+/* As verify_start(), with the public key already in p_state->l_public. */
+static int verify_start_point(Verify_state *p_state,
+    const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
+{
+    uECC_word_t *u1 = p_state->u1;
+    uECC_word_t *u2 = p_state->u2;
+    uECC_word_t *r = p_state->r;
+    uECC_word_t *z = p_state->z;
+    uECC_word_t s[uECC_N_WORDS];
 
-    uECC_word_t r[uECC_N_WORDS], s[uECC_N_WORDS];
     r[uECC_N_WORDS-1] = 0;
     s[uECC_N_WORDS-1] = 0;
 
-    vli_bytesToNative(l_public.x, p_publicKey);
-    vli_bytesToNative(l_public.y, p_publicKey + uECC_BYTES);
     vli_bytesToNative(r, p_signature);
     vli_bytesToNative(s, p_signature + uECC_BYTES);
 
@@ -2426,33 +3203,71 @@ int uECC_verify_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_ha
     vli_modMult_n(u1, u1, z); /* u1 = e/s */
     vli_modMult_n(u2, r, z); /* u2 = r/s */
 
+    shamir_start(p_state);
+    return 1;
+}
+
+/* Returns 0 if the signature is rejected outright. */
+static int verify_start(Verify_state *p_state, const uint8_t p_publicKey[uECC_BYTES*2],
+    const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
+{
+    vli_bytesToNative(p_state->l_public.x, p_publicKey);
+    vli_bytesToNative(p_state->l_public.y, p_publicKey + uECC_BYTES);
+    return verify_start_point(p_state, p_hash, p_signature);
+}
+
+/* Set up u1 * G + u2 * Q for verify_run() from u1, u2 and Q (l_public). */
+static void shamir_start(Verify_state *p_state)
+{
+    uECC_word_t *u1 = p_state->u1;
+    uECC_word_t *u2 = p_state->u2;
+    uECC_word_t *z = p_state->z;
+    EccPoint *l_public = &p_state->l_public;
+    EccPoint *l_sum = &p_state->l_sum;
+    uECC_word_t tx[uECC_WORDS];
+    uECC_word_t ty[uECC_WORDS];
+
     /* Calculate l_sum = G + Q. */
-    vli_set(l_sum.x, l_public.x);
-    vli_set(l_sum.y, l_public.y);
+    vli_set(l_sum->x, l_public->x);
+    vli_set(l_sum->y, l_public->y);
     vli_set(tx, curve_G.x);
     vli_set(ty, curve_G.y);
-    vli_modSub_fast(z, l_sum.x, tx); /* Z = x2 - x1 */
-    XYcZ_add(tx, ty, l_sum.x, l_sum.y);
+    vli_modSub_fast(z, l_sum->x, tx); /* Z = x2 - x1 */
+    XYcZ_add(tx, ty, l_sum->x, l_sum->y);
     vli_modInv(z, z, curve_p); /* Z = 1/Z */
-    apply_z(l_sum.x, l_sum.y, z);
+    apply_z(l_sum->x, l_sum->y, z);
 
     /* Use Shamir's trick to calculate u1*G + u2*Q */
-    EccPoint *l_points[4] = {0, &curve_G, &l_public, &l_sum};
     bitcount_t l_numBits = smax(vli_numBits(u1, uECC_N_WORDS), vli_numBits(u2, uECC_N_WORDS));
+    uECC_word_t l_index = (!!vli_testBit(u1, l_numBits-1)) | ((!!vli_testBit(u2, l_numBits-1)) << 1);
+    const EccPoint *l_point = (l_index == 1) ? &curve_G : (l_index == 2) ? l_public : l_sum;
 
-    EccPoint *l_point = l_points[(!!vli_testBit(u1, l_numBits-1)) | ((!!vli_testBit(u2, l_numBits-1)) << 1)];
-    vli_set(rx, l_point->x);
-    vli_set(ry, l_point->y);
+    vli_set(p_state->rx, l_point->x);
+    vli_set(p_state->ry, l_point->y);
     vli_clear(z);
     z[0] = 1;
+    p_state->bit = l_numBits - 2;
+}
 
+/* Process up to p_bits bits. Returns nonzero once all are done. */
+static uECC_word_t verify_run(Verify_state *p_state, unsigned p_bits)
+{
+    const EccPoint *l_points[4] = {0, &curve_G, &p_state->l_public, &p_state->l_sum};
+    uECC_word_t *rx = p_state->rx;
+    uECC_word_t *ry = p_state->ry;
+    uECC_word_t *z = p_state->z;
+    uECC_word_t tx[uECC_WORDS];
+    uECC_word_t ty[uECC_WORDS];
+    uECC_word_t tz[uECC_WORDS];
     bitcount_t i;
-    for(i = l_numBits - 2; i >= 0; --i)
+
+    for(; p_state->bit >= 0 && p_bits; --p_state->bit, --p_bits)
     {
+        i = p_state->bit;
         EccPoint_double_jacobian(rx, ry, z);
 
-        uECC_word_t l_index = (!!vli_testBit(u1, i)) | ((!!vli_testBit(u2, i)) << 1);
-        l_point = l_points[l_index];
+        uECC_word_t l_index = (!!vli_testBit(p_state->u1, i)) | ((!!vli_testBit(p_state->u2, i)) << 1);
+        const EccPoint *l_point = l_points[l_index];
         if(l_point)
         {
             vli_set(tx, l_point->x);
@@ -2464,8 +3279,15 @@ int uECC_verify_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_ha
         }
     }
 
-    vli_modInv(z, z, curve_p); /* Z = 1/Z */
-    apply_z(rx, ry, z);
+    return (p_state->bit < 0);
+}
+
+static int verify_finish(Verify_state *p_state)
+{
+    uECC_word_t *rx = p_state->rx;
+
+    vli_modInv(p_state->z, p_state->z, curve_p); /* Z = 1/Z */
+    apply_z(rx, p_state->ry, p_state->z);
 
     /* v = x1 (mod n) */
 #if (uECC_CURVE != uECC_secp160r1)
@@ -2476,5 +3298,549 @@ int uECC_verify_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_ha
 #endif
 
     /* Accept only if v == r. */
-    return (vli_cmp(rx, r) == 0);
+    return (vli_cmp(rx, p_state->r) == 0);
 }
+
+int uECC_verify_impl(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
+{
+    Verify_state l_state;
+
+    if(!verify_start(&l_state, p_publicKey, p_hash, p_signature))
+    {
+        return 0;
+    }
+    verify_run(&l_state, uECC_N_WORDS * uECC_WORD_SIZE * 8);
+    return verify_finish(&l_state);
+}
+
+int uECC_verify_key(const uECC_Key *p_key, const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
+{
+    const Key_handle *l_key = key_get(p_key, KEY_VALID);
+    Verify_state l_state;
+
+    uECC_COUNT_START();
+    if(!l_key)
+    {
+        return 0;
+    }
+
+    vli_set(l_state.l_public.x, l_key->point.x);
+    vli_set(l_state.l_public.y, l_key->point.y);
+    if(!verify_start_point(&l_state, p_hash, p_signature))
+    {
+        return 0;
+    }
+    verify_run(&l_state, uECC_N_WORDS * uECC_WORD_SIZE * 8);
+    return verify_finish(&l_state);
+}
+
+#if (uECC_CURVE != uECC_secp160r1)
+
+/* Recovers the public key into p_public, checked to be on the curve. */
+static int recover_point(const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2],
+    int p_recid, EccPoint *p_public)
+{
+    Verify_state l_state;
+    uECC_word_t r[uECC_WORDS];
+    uECC_word_t s[uECC_WORDS];
+    uECC_word_t e[uECC_WORDS];
+    uECC_word_t l_rinv[uECC_WORDS];
+    uint8_t l_compressed[uECC_BYTES + 1];
+
+    if(p_recid < 0 || p_recid > 3)
+    {
+        return 0;
+    }
+
+    vli_bytesToNative(r, p_signature);
+    vli_bytesToNative(s, p_signature + uECC_BYTES);
+    if(vli_isZero(r) || vli_isZero(s) || vli_cmp(curve_n, r) != 1 || vli_cmp(curve_n, s) != 1)
+    {
+        return 0;
+    }
+
+    /* R.x = r, or r + n for recovery ids 2 and 3; it must be below p. */
+    vli_set(l_rinv, r);
+    if(p_recid & 2)
+    {
+        if(vli_add(l_rinv, r, curve_n))
+        {
+            return 0;
+        }
+    }
+    if(vli_cmp(curve_p, l_rinv) != 1)
+    {
+        return 0;
+    }
+
+    /* R from its x coordinate and the parity of y. */
+    l_compressed[0] = 2 + (p_recid & 1);
+    vli_nativeToBytes(l_compressed + 1, l_rinv);
+    point_decompress(&l_state.l_public, l_compressed);
+    if(!EccPoint_isValid(&l_state.l_public))
+    {
+        return 0;
+    }
+
+    /* Q = r^-1 (s R - e G) = (-e / r) G + (s / r) R */
+    vli_bytesToNative(e, p_hash);
+    if(vli_cmp(curve_n, e) != 1)
+    {
+        vli_sub(e, e, curve_n);
+    }
+    if(!vli_isZero(e))
+    {
+        vli_sub(e, curve_n, e);
+    }
+    vli_modInv_n(l_rinv, r, curve_n);
+    vli_modMult_n(l_state.u1, e, l_rinv);
+    vli_modMult_n(l_state.u2, s, l_rinv);
+
+    shamir_start(&l_state);
+    verify_run(&l_state, uECC_BYTES * 8);
+
+    vli_modInv(l_state.z, l_state.z, curve_p);
+    apply_z(l_state.rx, l_state.ry, l_state.z);
+    vli_set(l_state.l_sum.x, l_state.rx);
+    vli_set(l_state.l_sum.y, l_state.ry);
+    if(!EccPoint_isValid(&l_state.l_sum))
+    {
+        return 0;
+    }
+
+    vli_set(p_public->x, l_state.rx);
+    vli_set(p_public->y, l_state.ry);
+    return 1;
+}
+
+int uECC_recover(const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2],
+    int p_recid, uint8_t p_publicKey[uECC_BYTES*2])
+{
+    EccPoint l_public;
+
+    uECC_COUNT_START();
+    if(!recover_point(p_hash, p_signature, p_recid, &l_public))
+    {
+        return 0;
+    }
+
+    vli_nativeToBytes(p_publicKey, l_public.x);
+    vli_nativeToBytes(p_publicKey + uECC_BYTES, l_public.y);
+    return 1;
+}
+
+int uECC_recover_key(const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2],
+    int p_recid, uECC_Key *p_key)
+{
+    Key_handle *l_key = (Key_handle *)p_key;
+
+    uECC_COUNT_START();
+    uECC_key_wipe(p_key);
+    if(!recover_point(p_hash, p_signature, p_recid, &l_key->point))
+    {
+        return 0;
+    }
+
+    l_key->curve = g_curve;
+    l_key->flags = KEY_VALID;
+    return 1;
+}
+
+/* Resumable signing and verification. The contexts remember the curve they
+   were started on, so other curve users may run between steps. */
+
+typedef struct
+{
+    const struct uECC_Curve_t *curve;
+    uECC_word_t k[uECC_N_WORDS];
+    uint8_t privateKey[uECC_BYTES];
+    uint8_t hash[uECC_BYTES];
+    MultG_state mult;
+    uECC_word_t tries;
+} Sign_state;
+
+typedef struct
+{
+    const struct uECC_Curve_t *curve;
+    Verify_state verify;
+} Verify_step_state;
+
+/* uecc.h sizes the contexts from these layouts. Each state must fit its size,
+   and may fall short of it only by the padding allowed for its pointers and
+   counters, three in Sign_state and two in Verify_step_state. */
+typedef char uECC_sign_ctx_size_check[(sizeof(Sign_state) <= uECC_SIGN_STATE_SIZE) ? 1 : -1];
+typedef char uECC_verify_ctx_size_check[(sizeof(Verify_step_state) <= uECC_VERIFY_STATE_SIZE) ? 1 : -1];
+typedef char uECC_sign_ctx_slack_check[(uECC_SIGN_STATE_SIZE - sizeof(Sign_state) < 3 * uECC_STATE_SLOT) ? 1 : -1];
+typedef char uECC_verify_ctx_slack_check[(uECC_VERIFY_STATE_SIZE - sizeof(Verify_step_state) < 2 * uECC_STATE_SLOT) ? 1 : -1];
+
+static void wipe(void *p_buf, unsigned p_size)
+{
+    volatile uint8_t *l_buf = (volatile uint8_t *)p_buf;
+    while(p_size--)
+    {
+        *l_buf++ = 0;
+    }
+}
+
+/* Pick a fresh nonce and start k * G. */
+static int sign_state_nonce(Sign_state *p_state)
+{
+    do
+    {
+        if(!uECC_RNG((uint8_t *)p_state->k, sizeof(p_state->k)) || (p_state->tries++ >= MAX_TRIES))
+        {
+            return 0;
+        }
+    } while(vli_isZero(p_state->k) || vli_cmp(curve_n, p_state->k) != 1);
+
+    EccPoint_mult_G_start(&p_state->mult);
+    return 1;
+}
+
+int uECC_sign_begin(uECC_SignContext *p_ctx, const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES])
+{
+    Sign_state *l_state = (Sign_state *)p_ctx;
+    wordcount_t i;
+
+    uECC_COUNT_START();
+    l_state->curve = g_curve;
+    l_state->tries = 0;
+    for(i = 0; i < uECC_BYTES; ++i)
+    {
+        l_state->privateKey[i] = p_privateKey[i];
+        l_state->hash[i] = p_hash[i];
+    }
+
+    if(!sign_state_nonce(l_state))
+    {
+        uECC_sign_abort(p_ctx);
+        return 0;
+    }
+    return 1;
+}
+
+int uECC_sign_step(uECC_SignContext *p_ctx, unsigned p_iterations, uint8_t p_signature[uECC_BYTES*2])
+{
+    Sign_state *l_state = (Sign_state *)p_ctx;
+    const struct uECC_Curve_t *l_saved = g_curve;
+    uECC_word_t l_tmp[uECC_N_WORDS];
+    uECC_word_t s[uECC_N_WORDS];
+    EccPoint p;
+    int l_result = 1;
+
+    g_curve = l_state->curve;
+
+    if(!EccPoint_mult_G_run(&l_state->mult, l_state->k, p_iterations))
+    {
+        g_curve = l_saved;
+        return uECC_IN_PROGRESS;
+    }
+
+    /* r = x1 (mod n) */
+    EccPoint_mult_G_finish(&l_state->mult, &p);
+    if(vli_cmp(curve_n, p.x) != 1)
+    {
+        vli_sub(p.x, p.x, curve_n);
+    }
+    if(vli_isZero(p.x))
+    {
+        l_result = sign_state_nonce(l_state) ? uECC_IN_PROGRESS : 0;
+        g_curve = l_saved;
+        if(!l_result)
+        {
+            uECC_sign_abort(p_ctx);
+        }
+        return l_result;
+    }
+
+    l_state->tries = 0;
+    do
+    {
+        if(!uECC_RNG((uint8_t *)l_tmp, sizeof(l_tmp)) || (l_state->tries++ >= MAX_TRIES))
+        {
+            l_result = 0;
+            break;
+        }
+    } while(vli_isZero(l_tmp));
+
+    if(l_result)
+    {
+        /* Blinded inversion as in uECC_sign_impl(). */
+        vli_modMult_n(l_state->k, l_state->k, l_tmp); /* k' = rand * k */
+        vli_modInv_n(l_state->k, l_state->k, curve_n); /* k = 1 / k' */
+        vli_modMult_n(l_state->k, l_state->k, l_tmp); /* k = 1 / k */
+
+        vli_nativeToBytes(p_signature, p.x); /* store r */
+
+        vli_bytesToNative(l_tmp, l_state->privateKey); /* tmp = d */
+        vli_set(s, p.x);
+        vli_modMult_n(s, l_tmp, s); /* s = r*d */
+
+        vli_bytesToNative(l_tmp, l_state->hash);
+        vli_modAdd_n(s, l_tmp, s, curve_n); /* s = e + r*d */
+        vli_modMult_n(s, s, l_state->k); /* s = (e + r*d) / k */
+        vli_nativeToBytes(p_signature + uECC_BYTES, s);
+    }
+
+    wipe(l_tmp, sizeof(l_tmp));
+    wipe(s, sizeof(s));
+    uECC_sign_abort(p_ctx);
+    g_curve = l_saved;
+    return l_result;
+}
+
+void uECC_sign_abort(uECC_SignContext *p_ctx)
+{
+    wipe(p_ctx, sizeof(*p_ctx));
+}
+
+int uECC_sign_nonce(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_k[uECC_BYTES],
+    const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2])
+{
+    uECC_SignContext l_ctx;
+    Sign_state *l_state = (Sign_state *)&l_ctx;
+    wordcount_t i;
+    int l_result;
+
+    uECC_COUNT_START();
+    l_state->curve = g_curve;
+    l_state->tries = 0;
+    for(i = 0; i < uECC_BYTES; ++i)
+    {
+        l_state->privateKey[i] = p_privateKey[i];
+        l_state->hash[i] = p_hash[i];
+    }
+
+    vli_bytesToNative(l_state->k, p_k);
+    if(vli_isZero(l_state->k) || vli_cmp(curve_n, l_state->k) != 1)
+    {
+        uECC_sign_abort(&l_ctx);
+        return 0;
+    }
+    EccPoint_mult_G_start(&l_state->mult);
+
+    /* Only an r of zero, which needs a fresh nonce, takes more than one pass. */
+    do
+    {
+        l_result = uECC_sign_step(&l_ctx, uECC_BYTES * 8, p_signature);
+    } while(l_result == uECC_IN_PROGRESS);
+    return l_result;
+}
+
+int uECC_verify_begin(uECC_VerifyContext *p_ctx, const uint8_t p_publicKey[uECC_BYTES*2],
+    const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2])
+{
+    Verify_step_state *l_state = (Verify_step_state *)p_ctx;
+
+    uECC_COUNT_START();
+    l_state->curve = g_curve;
+    return verify_start(&l_state->verify, p_publicKey, p_hash, p_signature);
+}
+
+int uECC_verify_step(uECC_VerifyContext *p_ctx, unsigned p_iterations)
+{
+    Verify_step_state *l_state = (Verify_step_state *)p_ctx;
+    const struct uECC_Curve_t *l_saved = g_curve;
+    int l_result = uECC_IN_PROGRESS;
+
+    g_curve = l_state->curve;
+    if(verify_run(&l_state->verify, p_iterations))
+    {
+        l_result = verify_finish(&l_state->verify);
+    }
+    g_curve = l_saved;
+    return l_result;
+}
+
+/* Workspace variants: the resumable state machines run to completion with their
+   state in the caller's arena. */
+
+typedef struct
+{
+    uECC_word_t privateKey[uECC_WORDS];
+    MultG_state mult;
+    EccPoint result;
+} Key_state;
+
+/* As for the contexts: Key_state has one counter, the comb column or the
+   done flag of the k*G state. The workspace is the largest of the three. */
+typedef char uECC_key_ws_size_check[(sizeof(Key_state) <= uECC_KEY_STATE_SIZE) ? 1 : -1];
+typedef char uECC_key_ws_slack_check[(uECC_KEY_STATE_SIZE - sizeof(Key_state) < uECC_STATE_SLOT) ? 1 : -1];
+typedef char uECC_ws_size_check[(sizeof(uECC_Workspace) == (uECC_WORKSPACE_SIZE + 7) / 8 * 8) ? 1 : -1];
+
+int uECC_make_key_ws(uECC_Workspace *p_ws, uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[uECC_BYTES])
+{
+    Key_state *l_state = (Key_state *)p_ws;
+    uECC_word_t l_tries = 0;
+    int l_result = 0;
+
+    uECC_COUNT_START();
+    for(;;)
+    {
+        if(!uECC_RNG((uint8_t *)l_state->privateKey, sizeof(l_state->privateKey)) || (l_tries++ >= MAX_TRIES))
+        {
+            goto done;
+        }
+
+        /* Make sure the private key is in the range [1, n-1]. */
+        if(vli_isZero(l_state->privateKey) || vli_cmp(curve_n, l_state->privateKey) != 1)
+        {
+            continue;
+        }
+
+        EccPoint_mult_G_start(&l_state->mult);
+        EccPoint_mult_G_run(&l_state->mult, l_state->privateKey, (unsigned)-1);
+        EccPoint_mult_G_finish(&l_state->mult, &l_state->result);
+        if(!EccPoint_isZero(&l_state->result))
+        {
+            break;
+        }
+    }
+
+    vli_nativeToBytes(p_privateKey, l_state->privateKey);
+    vli_nativeToBytes(p_publicKey, l_state->result.x);
+    vli_nativeToBytes(p_publicKey + uECC_BYTES, l_state->result.y);
+    l_result = 1;
+
+done:
+    wipe(p_ws, sizeof(*p_ws));
+    return l_result;
+}
+
+int uECC_sign_ws(uECC_Workspace *p_ws, const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES],
+    uint8_t p_signature[uECC_BYTES*2])
+{
+    int l_result;
+
+    if(!uECC_sign_begin(&p_ws->sign, p_privateKey, p_hash))
+    {
+        return 0;
+    }
+
+    do
+    {
+        l_result = uECC_sign_step(&p_ws->sign, (unsigned)-1, p_signature);
+    } while(l_result == uECC_IN_PROGRESS);
+
+    return l_result;
+}
+
+int uECC_verify_ws(uECC_Workspace *p_ws, const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uECC_BYTES],
+    const uint8_t p_signature[uECC_BYTES*2])
+{
+    if(!uECC_verify_begin(&p_ws->verify, p_publicKey, p_hash, p_signature))
+    {
+        return 0;
+    }
+
+    return uECC_verify_step(&p_ws->verify, (unsigned)-1);
+}
+
+/* Batch signing. Montgomery's trick: with a_i = b * k_0 * ... * k_i for a random
+   blinding factor b, one inversion of a_last gives every 1 / k_i by walking back
+   down the products. */
+int uECC_sign_batch(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hashes[][uECC_BYTES],
+    uint8_t p_signatures[][uECC_BYTES*2], unsigned p_count)
+{
+    uECC_word_t d[uECC_WORDS];
+    uECC_word_t k[uECC_SIGN_BATCH][uECC_WORDS];
+    uECC_word_t l_acc[uECC_SIGN_BATCH][uECC_WORDS];
+    uECC_word_t l_inv[uECC_WORDS];
+    uECC_word_t l_blind[uECC_WORDS];
+    uECC_word_t s[uECC_WORDS];
+    EccPoint p;
+    unsigned l_done;
+    unsigned l_group;
+    unsigned i;
+    uECC_word_t l_tries;
+    int l_result = 0;
+
+    uECC_COUNT_START();
+
+    /* Make sure the private key is in the range [1, n-1]. */
+    vli_bytesToNative(d, p_privateKey);
+    if(vli_isZero(d) || vli_cmp(curve_n, d) != 1)
+    {
+        goto done;
+    }
+
+    for(l_done = 0; l_done < p_count; l_done += l_group)
+    {
+        l_group = p_count - l_done;
+        if(l_group > uECC_SIGN_BATCH)
+        {
+            l_group = uECC_SIGN_BATCH;
+        }
+
+        l_tries = 0;
+        do
+        {
+            if(!uECC_RNG((uint8_t *)l_blind, sizeof(l_blind)) || (l_tries++ >= MAX_TRIES))
+            {
+                goto done;
+            }
+        } while(vli_isZero(l_blind) || vli_cmp(curve_n, l_blind) != 1);
+
+        /* r_i = (k_i * G).x mod n, drawing k_i again until r_i is nonzero. */
+        for(i = 0; i < l_group; ++i)
+        {
+            l_tries = 0;
+            for(;;)
+            {
+                if(!uECC_RNG((uint8_t *)k[i], sizeof(k[i])) || (l_tries++ >= MAX_TRIES))
+                {
+                    goto done;
+                }
+                if(vli_isZero(k[i]) || vli_cmp(curve_n, k[i]) != 1)
+                {
+                    continue;
+                }
+
+                EccPoint_mult_G(&p, k[i]);
+                if(vli_cmp(curve_n, p.x) != 1)
+                {
+                    vli_sub(p.x, p.x, curve_n);
+                }
+                if(!vli_isZero(p.x))
+                {
+                    break;
+                }
+            }
+            vli_nativeToBytes(p_signatures[l_done + i], p.x); /* store r */
+
+            vli_modMult_n(l_acc[i], (i ? l_acc[i - 1] : l_blind), k[i]); /* a_i = a_(i-1) * k_i */
+        }
+
+        /* l_inv = 1 / a_last, then peel off one k at a time. */
+        vli_modInv_n(l_inv, l_acc[l_group - 1], curve_n);
+        for(i = l_group - 1; i > 0; --i)
+        {
+            vli_modMult_n(s, l_inv, l_acc[i - 1]); /* 1 / k_i */
+            vli_modMult_n(l_inv, l_inv, k[i]); /* 1 / a_(i-1) */
+            vli_set(k[i], s);
+        }
+        vli_modMult_n(k[0], l_inv, l_blind); /* 1 / k_0 */
+
+        for(i = 0; i < l_group; ++i)
+        {
+            vli_bytesToNative(s, p_signatures[l_done + i]); /* s = r */
+            vli_modMult_n(s, d, s); /* s = r*d */
+            vli_bytesToNative(l_inv, p_hashes[l_done + i]);
+            vli_modAdd_n(s, l_inv, s, curve_n); /* s = e + r*d */
+            vli_modMult_n(s, s, k[i]); /* s = (e + r*d) / k */
+            vli_nativeToBytes(p_signatures[l_done + i] + uECC_BYTES, s);
+        }
+    }
+    l_result = 1;
+
+done:
+    wipe(d, sizeof(d));
+    wipe(k, sizeof(k));
+    wipe(l_acc, sizeof(l_acc));
+    wipe(l_inv, sizeof(l_inv));
+    wipe(l_blind, sizeof(l_blind));
+    wipe(s, sizeof(s));
+    return l_result;
+}
+
+#endif /* uECC_CURVE != uECC_secp160r1 */
@@ -38,10 +38,31 @@ uECC_asm_fast  - Use GCC inline assembly optimized for maximum speed. */
     #define uECC_CURVE uECC_secp256r1
 #endif
 
+/* uECC_MULTI_CURVE - If enabled (defined as nonzero) and uECC_CURVE is one of the 256-bit curves,
+    both secp256k1 and secp256r1 are built in and the curve is chosen at run time with uECC_set_curve().
+    uECC_CURVE is then the curve in use at startup. Costs the flash for the second curve's reduction
+    and comb table. */
+#ifndef uECC_MULTI_CURVE
+    #define uECC_MULTI_CURVE 1
+#endif
+
 /* uECC_SQUARE_FUNC - If enabled (defined as nonzero), this will cause a specific function to be used for (scalar) squaring
     instead of the generic multiplication function. This will make things faster by about 8% but increases the code size. */
 #define uECC_SQUARE_FUNC 1
 
+/* uECC_PROFILE - If enabled (defined as nonzero), calls to the main arithmetic primitives and to the
+    RNG are counted per top-level operation and can be read back with uECC_get_counters(). When
+    disabled the counting is not compiled in at all. */
+#ifndef uECC_PROFILE
+    #define uECC_PROFILE 0
+#endif
+
+/* uECC_SIGN_BATCH - Number of signatures uECC_sign_batch() processes together, sharing one
+    nonce inversion between them. Each costs 2*uECC_BYTES bytes of stack. */
+#ifndef uECC_SIGN_BATCH
+    #define uECC_SIGN_BATCH 8
+#endif
+
 #define uECC_CONCAT1(a, b) a##b
 #define uECC_CONCAT(a, b) uECC_CONCAT1(a, b)
 
@@ -84,6 +105,42 @@ Inputs:
 */
 void uECC_set_rng(uECC_RNG_Function p_rng);
 
+/* uECC_get_rng() function.
+Returns the function currently used to generate random bytes.
+*/
+uECC_RNG_Function uECC_get_rng(void);
+
+/* uECC_word_size() function.
+Returns the size in bytes of the words uECC computes with (uECC_WORD_SIZE), which is
+chosen from the platform unless set explicitly.
+*/
+unsigned uECC_word_size(void);
+
+/* uECC_Curve type
+Handle to the parameters and specialized arithmetic of one curve.
+*/
+typedef const struct uECC_Curve_t * uECC_Curve;
+
+/* uECC_get_curve() function.
+Returns the curve currently used by all uECC operations.
+*/
+uECC_Curve uECC_get_curve(void);
+
+/* uECC_set_curve() function.
+Select the curve used by all subsequent uECC operations. Keys and signatures are only
+meaningful on the curve they were made with.
+
+Inputs:
+    p_curve  - The curve to use, from uECC_curve_secp256k1() or uECC_curve_secp256r1().
+
+Returns 1 if the curve was selected, 0 if p_curve is NULL.
+*/
+int uECC_set_curve(uECC_Curve p_curve);
+
+/* Curves available for uECC_set_curve(). A curve that is not built in returns NULL. */
+uECC_Curve uECC_curve_secp256k1(void);
+uECC_Curve uECC_curve_secp256r1(void);
+
 //////////////////////////////////////////
 // DTLS_CRYPTO_HAL
 /**
@@ -304,6 +361,214 @@ Returns 1 if the signature is valid, 0 if it is invalid.
 */
 int uECC_verify(const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2]);
 
+/* uECC_recover() function.
+Recover the signer's public key from a signature and the signed hash.
+
+Inputs:
+    p_hash      - The hash of the signed data.
+    p_signature - The signature value.
+    p_recid     - Recovery id 0..3: bit 0 is the parity of R.y, bit 1 set if R.x = r + n.
+
+Outputs:
+    p_publicKey - Will be filled in with the public key.
+
+Returns 1 if a public key was recovered, 0 if the signature or recovery id is not usable.
+Not available for secp160r1.
+*/
+int uECC_recover(const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2],
+    int p_recid, uint8_t p_publicKey[uECC_BYTES*2]);
+
+/* Key handles.
+uECC_key_load() checks a public key once, decompressing it first if needed, and keeps it
+in the library's internal number format together with the curve it was checked on.
+uECC_verify_key(), uECC_shared_secret_key() and uECC_ecdhe_key() then use the handle
+without converting or checking the key again, which saves a square root per call for a
+compressed key. uECC_recover_key() produces an already checked handle.
+
+uECC_key_load_private() does the same for a key pair: the private key is range checked
+and the public key derived from it, and the handle can then be passed to uECC_sign_key().
+Such a handle holds a copy of the private key; call uECC_key_wipe() when it is no longer
+needed.
+
+A handle is only accepted while the curve it was loaded on is selected. The key handle
+functions always use the software implementation, never the uECC_set_*_cb() callbacks.
+*/
+#define uECC_KEY_SIZE 128
+
+typedef struct
+{
+    uint64_t opaque[uECC_KEY_SIZE / 8];
+} uECC_Key;
+
+/* Accepts an uncompressed key of uECC_BYTES*2 bytes (x followed by y) or a compressed key
+of uECC_BYTES+1 bytes (see uECC_compress()). Returns 1 if the key is a point on the
+current curve, 0 otherwise. */
+int uECC_key_load(uECC_Key *p_key, const uint8_t *p_publicKey, unsigned p_size);
+
+/* Returns 1 if the private key is in range, 0 otherwise. */
+int uECC_key_load_private(uECC_Key *p_key, const uint8_t p_privateKey[uECC_BYTES]);
+
+/* Returns 1 if the handle holds a checked key for the current curve, 0 otherwise. */
+int uECC_key_valid(const uECC_Key *p_key);
+
+/* Writes out the public key, x followed by y. Returns 0 if the handle is not valid. */
+int uECC_key_export(const uECC_Key *p_key, uint8_t p_publicKey[uECC_BYTES*2]);
+
+/* Clears the handle, including any private key it holds. */
+void uECC_key_wipe(uECC_Key *p_key);
+
+/* As uECC_sign(), uECC_verify(), uECC_shared_secret() and uECC_ecdhe(), taking the key
+from a handle. uECC_sign_key() needs a handle made by uECC_key_load_private(). All
+return 0 if the handle is not valid for the current curve. */
+int uECC_sign_key(const uECC_Key *p_key, const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2]);
+int uECC_verify_key(const uECC_Key *p_key, const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2]);
+int uECC_shared_secret_key(const uECC_Key *p_key, const uint8_t p_privateKey[uECC_BYTES], uint8_t p_secret[uECC_BYTES]);
+int uECC_ecdhe_key(const uECC_Key *p_key, uint8_t p_public_key_out[uECC_BYTES*2], uint8_t p_secret[uECC_BYTES]);
+
+/* As uECC_recover(), filling in a key handle. Not available for secp160r1. */
+int uECC_recover_key(const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2],
+    int p_recid, uECC_Key *p_key);
+
+/* Resumable signing and verification.
+Lets a cooperative scheduler run other work while a signature is computed. The
+context carries the scalar multiplication state between calls and each step
+processes at most p_iterations loop iterations: comb columns when signing,
+scalar bits when verifying. A signature needs 64 comb columns on the 256-bit
+curves, a verification about 256 bits. The context keeps the curve selected at
+begin time. Not available for secp160r1.
+
+uECC_sign_step() and uECC_verify_step() return uECC_IN_PROGRESS until the work is
+done, then the same value as uECC_sign() or uECC_verify(). A signing context holds
+a copy of the private key until it finishes; call uECC_sign_abort() to wipe one
+that is abandoned.
+*/
+#define uECC_IN_PROGRESS 2
+
+/* Sizes of the operation states kept in the contexts and the workspace below,
+following their layouts in uecc.c. Each big number takes uECC_BYTES and each
+pointer or counter one uECC_STATE_SLOT, which covers its size and padding on
+every word size. uecc.c checks every state against its size at compile time,
+so a layout change that is not made here as well fails to build. */
+#define uECC_STATE_SLOT 8
+
+#if (uECC_CURVE == uECC_secp256r1 || uECC_CURVE == uECC_secp256k1)
+/* Comb accumulator X, Y, Z and the column counter. */
+#define uECC_MULT_G_STATE_SIZE (3 * uECC_BYTES + uECC_STATE_SLOT)
+#else
+/* Result point and a done flag. */
+#define uECC_MULT_G_STATE_SIZE (2 * uECC_BYTES + uECC_STATE_SLOT)
+#endif
+
+/* Curve, nonce, private key, hash, k*G state and retry count. */
+#define uECC_SIGN_STATE_SIZE \
+    (uECC_STATE_SLOT + 3 * uECC_BYTES + uECC_MULT_G_STATE_SIZE + uECC_STATE_SLOT)
+/* Curve, u1, u2, public key, running sum, rx, ry, z, r and the bit counter. */
+#define uECC_VERIFY_STATE_SIZE \
+    (uECC_STATE_SLOT + 10 * uECC_BYTES + uECC_STATE_SLOT)
+/* Private key, k*G state and public key. */
+#define uECC_KEY_STATE_SIZE \
+    (3 * uECC_BYTES + uECC_MULT_G_STATE_SIZE)
+
+#define uECC_SIGN_CTX_SIZE   uECC_SIGN_STATE_SIZE
+#define uECC_VERIFY_CTX_SIZE uECC_VERIFY_STATE_SIZE
+
+typedef struct
+{
+    uint64_t opaque[(uECC_SIGN_CTX_SIZE + 7) / 8];
+} uECC_SignContext;
+
+typedef struct
+{
+    uint64_t opaque[(uECC_VERIFY_CTX_SIZE + 7) / 8];
+} uECC_VerifyContext;
+
+/* Draws the nonce. Returns 1 on success, 0 if the RNG failed. */
+int uECC_sign_begin(uECC_SignContext *p_ctx, const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES]);
+int uECC_sign_step(uECC_SignContext *p_ctx, unsigned p_iterations, uint8_t p_signature[uECC_BYTES*2]);
+void uECC_sign_abort(uECC_SignContext *p_ctx);
+
+/* Signs with a caller supplied nonce p_k, e.g. one drawn by a hardware RNG or taken from
+a known-answer test vector, instead of drawing one from the RNG. p_k must be in [1, n-1],
+secret and never reused. Returns 1 on success, 0 if p_k is out of range. */
+int uECC_sign_nonce(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_k[uECC_BYTES],
+    const uint8_t p_hash[uECC_BYTES], uint8_t p_signature[uECC_BYTES*2]);
+
+/* Returns 1 if verification has started, 0 if the signature is rejected outright. */
+int uECC_verify_begin(uECC_VerifyContext *p_ctx, const uint8_t p_publicKey[uECC_BYTES*2],
+    const uint8_t p_hash[uECC_BYTES], const uint8_t p_signature[uECC_BYTES*2]);
+int uECC_verify_step(uECC_VerifyContext *p_ctx, unsigned p_iterations);
+
+/* Workspace variants.
+uECC_make_key_ws(), uECC_sign_ws() and uECC_verify_ws() behave like uECC_make_key(),
+uECC_sign() and uECC_verify(), but keep the operation state (scalars, the running
+point, the verification sum point) in a caller-supplied workspace rather than on the
+stack, so one static arena can serve every operation in turn. Only the fixed
+field-arithmetic temporaries of the innermost routines remain on the stack.
+uECC_WORKSPACE_SIZE is the space the largest of the three needs in this configuration,
+taken from the state sizes above. Key generation and signing
+wipe the workspace before returning. The operations take no other lock, so a
+workspace must not be shared by calls that can interleave. Not available for secp160r1.
+*/
+#define uECC_WORKSPACE_SIZE_2(a, b)     ((a) > (b) ? (a) : (b))
+#define uECC_WORKSPACE_SIZE \
+    uECC_WORKSPACE_SIZE_2(uECC_KEY_STATE_SIZE, \
+        uECC_WORKSPACE_SIZE_2(uECC_SIGN_CTX_SIZE, uECC_VERIFY_CTX_SIZE))
+
+typedef union
+{
+    uECC_SignContext sign;
+    uECC_VerifyContext verify;
+    uint64_t opaque[(uECC_WORKSPACE_SIZE + 7) / 8];
+} uECC_Workspace;
+
+int uECC_make_key_ws(uECC_Workspace *p_ws, uint8_t p_publicKey[uECC_BYTES*2], uint8_t p_privateKey[uECC_BYTES]);
+int uECC_sign_ws(uECC_Workspace *p_ws, const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hash[uECC_BYTES],
+    uint8_t p_signature[uECC_BYTES*2]);
+int uECC_verify_ws(uECC_Workspace *p_ws, const uint8_t p_publicKey[uECC_BYTES*2], const uint8_t p_hash[uECC_BYTES],
+    const uint8_t p_signature[uECC_BYTES*2]);
+
+/* uECC_sign_batch() function.
+Sign several hashes with one private key. The key is parsed and range checked once, the
+nonce points k * G use the fixed-base comb where the curve has one, and the nonce inversions
+of each group of uECC_SIGN_BATCH signatures are done together with Montgomery's trick (one
+blinded inversion and three multiplications per signature). Each signature is as produced
+by uECC_sign(). Not available for secp160r1.
+
+Inputs:
+    p_privateKey - Your private key.
+    p_hashes     - p_count message hashes to sign.
+
+Outputs:
+    p_signatures - Will be filled in with the p_count signatures.
+
+Returns 1 if every signature was generated, 0 if an error occurred.
+*/
+int uECC_sign_batch(const uint8_t p_privateKey[uECC_BYTES], const uint8_t p_hashes[][uECC_BYTES],
+    uint8_t p_signatures[][uECC_BYTES*2], unsigned p_count);
+
+#if uECC_PROFILE
+/* Operation counters.
+Each top-level call (key generation, public key derivation, shared secret, signing,
+verification, recovery, the workspace variants, and the begin call of a resumable
+operation) clears the counters. A resumable operation keeps adding to them over all its
+steps, and uECC_decompress() adds to whatever is running. Squarings count as
+multiplications when uECC_SQUARE_FUNC is disabled.
+*/
+typedef struct
+{
+    uint32_t modMult;           /* vli_modMult_fast: field multiplications */
+    uint32_t modSquare;         /* vli_modSquare_fast: field squarings */
+    uint32_t modInv;            /* vli_modInv: inversions mod p or n */
+    uint32_t modMult_n;         /* vli_modMult_n: multiplications mod n */
+    uint32_t XYcZ_add;          /* XYcZ_add and XYcZ_addC: co-Z point additions */
+    uint32_t double_jacobian;   /* EccPoint_double_jacobian: point doublings */
+    uint32_t rng;               /* calls to the RNG function */
+} uECC_Counters;
+
+/* Copy out the counters of the most recent top-level operation. */
+void uECC_get_counters(uECC_Counters *p_counters);
+#endif /* uECC_PROFILE */
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
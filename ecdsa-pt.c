@@ -0,0 +1,129 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Protothread wrappers for resumable ECDSA operations.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include "contiki.h"
+#include "ecdsa-pt.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
+
+process_event_t ecdsa_event_done;
+
+void ecdsa_pt_init()
+{
+    if(!ecdsa_event_done)
+    {
+        ecdsa_event_done = process_alloc_event();
+    }
+}
+
+/* Whether the process has to poll itself to get the next step. Backends
+   working in the background poll the process that began the operation
+   when they finish, so until then it can sleep. */
+static int needs_self_poll(const ecdsa_engine_backend_t* b)
+{
+    return !(b && (b->caps & ECDSA_CAP_ASYNC));
+}
+
+PT_THREAD(ecdsa_sign_pt(
+    struct pt* pt,
+    ecdsa_sign_ctx_t* ctx,
+    struct process* notify))
+{
+    PT_BEGIN(pt);
+
+    while(ecdsa_sign_step(ctx) == ECDSA_STEP_AGAIN)
+    {
+        /* Come back as soon as the events queued meanwhile are handled. */
+        if(needs_self_poll(ctx->backend))
+        {
+            process_poll(PROCESS_CURRENT());
+        }
+        PT_YIELD(pt);
+    }
+
+    if(notify)
+    {
+        process_post(notify, ecdsa_event_done, ctx);
+    }
+
+    PT_END(pt);
+}
+
+PT_THREAD(ecdsa_verify_pt(
+    struct pt* pt,
+    ecdsa_verify_ctx_t* ctx,
+    struct process* notify))
+{
+    PT_BEGIN(pt);
+
+    while(ecdsa_verify_step(ctx) == ECDSA_STEP_AGAIN)
+    {
+        if(needs_self_poll(ctx->backend))
+        {
+            process_poll(PROCESS_CURRENT());
+        }
+        PT_YIELD(pt);
+    }
+
+    if(notify)
+    {
+        process_post(notify, ecdsa_event_done, ctx);
+    }
+
+    PT_END(pt);
+}
+
+PT_THREAD(ecdsa_pipeline_pt(
+    struct pt* pt,
+    ecdsa_pipeline_t* p,
+    struct process* notify))
+{
+    PT_BEGIN(pt);
+
+    while(ecdsa_pipeline_step(p) == ECDSA_STEP_AGAIN)
+    {
+        /* An item that failed to start has nothing to poll us. */
+        if(p->sign.status != ECDSA_STEP_AGAIN || needs_self_poll(p->sign.backend))
+        {
+            process_poll(PROCESS_CURRENT());
+        }
+        PT_YIELD(pt);
+    }
+
+    if(notify)
+    {
+        process_post(notify, ecdsa_event_done, p);
+    }
+
+    PT_END(pt);
+}
@@ -0,0 +1,85 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Protothread wrappers that run resumable ECDSA operations from a Contiki
+*    process, yielding to the scheduler between steps.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __ECDSA_PT_H
+#define __ECDSA_PT_H
+
+#include "contiki.h"
+#include "ecdsa-engine.h"
+
+/* Posted to the notify process when an operation completes. The data
+   pointer is the operation's context. */
+extern process_event_t ecdsa_event_done;
+
+/**
+ *  Allocate ecdsa_event_done. Call at startup before the wrappers; later
+ *  calls do nothing.
+ */
+void ecdsa_pt_init();
+
+/**
+ *  Step a signature started with ecdsa_sign_begin() to completion. Between
+ *  steps the calling process polls itself and yields, so pending events are
+ *  handled. On a backend with ECDSA_CAP_ASYNC it only yields, and is polled
+ *  by the backend when the result is ready; the operation must then have
+ *  been begun by the process running the protothread. Meant to be run with
+ *  PROCESS_PT_SPAWN().
+ *
+ *  @param(notify) [in] process to post ecdsa_event_done to, or NULL.
+ */
+PT_THREAD(ecdsa_sign_pt(
+    struct pt* pt,
+    ecdsa_sign_ctx_t* ctx,
+    struct process* notify));
+
+/**
+ *  Step a verification started with ecdsa_verify_begin() to completion.
+ */
+PT_THREAD(ecdsa_verify_pt(
+    struct pt* pt,
+    ecdsa_verify_ctx_t* ctx,
+    struct process* notify));
+
+/**
+ *  Run a pipeline started with ecdsa_pipeline_begin() to completion,
+ *  yielding between steps like ecdsa_sign_pt(). While an item is being
+ *  signed in the background the process sleeps until the backend polls it.
+ */
+PT_THREAD(ecdsa_pipeline_pt(
+    struct pt* pt,
+    ecdsa_pipeline_t* p,
+    struct process* notify));
+
+#endif
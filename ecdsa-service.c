@@ -0,0 +1,335 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Crypto service process.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include "contiki.h"
+#include "lib/list.h"
+#include <string.h>
+#include "ecdsa-service.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
+
+PROCESS(ecdsa_service_process, "ecdsa service");
+
+/* Jobs waiting to run, highest priority first. */
+LIST(g_queue);
+
+/* The job being run and its working state. */
+static ecdsa_job_t* g_current;
+static union
+{
+    ecdsa_sign_ctx_t sign;
+    ecdsa_verify_ctx_t verify;
+    struct
+    {
+        sha256_ctx_t sha;
+        uint32_t done;
+    } hash;
+} g_work;
+
+void ecdsa_service_init()
+{
+    ecdsa_pt_init();
+    process_start(&ecdsa_service_process, NULL);
+}
+
+void ecdsa_service_poll()
+{
+    process_poll(&ecdsa_service_process);
+}
+
+static int submit(ecdsa_job_t* job, uint8_t type, uint8_t priority)
+{
+    ecdsa_job_t* prev = NULL;
+    ecdsa_job_t* j;
+
+    if(job->state == ECDSA_JOB_QUEUED || job->state == ECDSA_JOB_RUNNING ||
+       list_length(g_queue) >= ECDSA_SERVICE_QUEUE_SIZE)
+    {
+        return -1;
+    }
+
+    job->owner = PROCESS_CURRENT();
+    job->type = type;
+    job->priority = priority;
+    job->state = ECDSA_JOB_QUEUED;
+    job->result = -1;
+
+    /* Behind every job of the same or higher priority. */
+    for(j = list_head(g_queue); j && j->priority >= priority; j = list_item_next(j))
+    {
+        prev = j;
+    }
+    if(prev)
+    {
+        list_insert(g_queue, prev, job);
+    }
+    else
+    {
+        list_push(g_queue, job);
+    }
+
+    ecdsa_service_poll();
+    return 0;
+}
+
+int ecdsa_service_sign(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t priv_key[32],
+    const uint8_t hash[32],
+    ecdsa_signature_t* sig)
+{
+    job->op.sign.priv_key = priv_key;
+    job->op.sign.hash = hash;
+    job->op.sign.sig = sig;
+    return submit(job, ECDSA_JOB_SIGN, priority);
+}
+
+int ecdsa_service_verify(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig)
+{
+    job->op.verify.pub_key = pub_key;
+    job->op.verify.hash = hash;
+    job->op.verify.sig = sig;
+    return submit(job, ECDSA_JOB_VERIFY, priority);
+}
+
+int ecdsa_service_recover(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig,
+    int recid,
+    uint8_t pub_key[64])
+{
+    job->op.recover.hash = hash;
+    job->op.recover.sig = sig;
+    job->op.recover.recid = recid;
+    job->op.recover.pub_key = pub_key;
+    return submit(job, ECDSA_JOB_RECOVER, priority);
+}
+
+int ecdsa_service_hash(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t* message,
+    uint32_t len,
+    uint8_t hash[32])
+{
+    job->op.hash.message = message;
+    job->op.hash.len = len;
+    job->op.hash.hash = hash;
+    return submit(job, ECDSA_JOB_HASH, priority);
+}
+
+static void wipe_work()
+{
+    memset(&g_work, 0, sizeof(g_work));
+}
+
+int ecdsa_service_cancel(ecdsa_job_t* job)
+{
+    if(job->state == ECDSA_JOB_QUEUED)
+    {
+        list_remove(g_queue, job);
+    }
+    else if(job->state == ECDSA_JOB_RUNNING && job == g_current)
+    {
+        /* The backend may still be working on g_work in the background;
+           stop it before the state goes. */
+        if(job->type == ECDSA_JOB_SIGN)
+        {
+            ecdsa_sign_abort(&g_work.sign);
+        }
+        else if(job->type == ECDSA_JOB_VERIFY)
+        {
+            ecdsa_verify_abort(&g_work.verify);
+        }
+        g_current = NULL;
+        wipe_work();
+        ecdsa_service_poll();
+    }
+    else
+    {
+        return -1;
+    }
+
+    job->state = ECDSA_JOB_CANCELLED;
+    job->result = -1;
+    return 0;
+}
+
+/* Start the job. Returns ECDSA_STEP_AGAIN if it has more work to do,
+   otherwise its result. */
+static int start(ecdsa_job_t* job)
+{
+    switch(job->type)
+    {
+    case ECDSA_JOB_SIGN:
+        if(ecdsa_sign_begin(&g_work.sign, job->op.sign.priv_key, job->op.sign.hash) != 0)
+        {
+            return -1;
+        }
+        return ECDSA_STEP_AGAIN;
+
+    case ECDSA_JOB_VERIFY:
+        if(ecdsa_verify_begin(&g_work.verify, job->op.verify.pub_key,
+            job->op.verify.hash, job->op.verify.sig) != 0)
+        {
+            return -1;
+        }
+        return ECDSA_STEP_AGAIN;
+
+    case ECDSA_JOB_RECOVER:
+        return ecdsa_recover(job->op.recover.hash, job->op.recover.sig,
+            job->op.recover.recid, job->op.recover.pub_key);
+
+    case ECDSA_JOB_HASH:
+        sha256_init(&g_work.hash.sha);
+        g_work.hash.done = 0;
+        return ECDSA_STEP_AGAIN;
+
+    default:
+        return -1;
+    }
+}
+
+/* Do one slot of work on the job. Same return as start(). */
+static int step(ecdsa_job_t* job)
+{
+    int status;
+    uint32_t n;
+
+    switch(job->type)
+    {
+    case ECDSA_JOB_SIGN:
+        status = ecdsa_sign_step(&g_work.sign);
+        if(status == 0)
+        {
+            status = ecdsa_sign_result(&g_work.sign, job->op.sign.sig);
+        }
+        return status;
+
+    case ECDSA_JOB_VERIFY:
+        return ecdsa_verify_step(&g_work.verify);
+
+    case ECDSA_JOB_HASH:
+        n = job->op.hash.len - g_work.hash.done;
+        if(n > ECDSA_SERVICE_HASH_CHUNK)
+        {
+            n = ECDSA_SERVICE_HASH_CHUNK;
+        }
+        sha256_update(&g_work.hash.sha, job->op.hash.message + g_work.hash.done, n);
+        g_work.hash.done += n;
+        if(g_work.hash.done < job->op.hash.len)
+        {
+            return ECDSA_STEP_AGAIN;
+        }
+        sha256_final(&g_work.hash.sha, job->op.hash.hash);
+        return 0;
+
+    default:
+        return -1;
+    }
+}
+
+/* Whether the running job waits for its backend to call ecdsa_service_poll()
+   rather than being stepped on every slot. */
+static int waits_for_backend(ecdsa_job_t* job)
+{
+    const ecdsa_engine_backend_t* b = NULL;
+
+    if(job->type == ECDSA_JOB_SIGN)
+    {
+        b = g_work.sign.backend;
+    }
+    else if(job->type == ECDSA_JOB_VERIFY)
+    {
+        b = g_work.verify.backend;
+    }
+    return b && (b->caps & ECDSA_CAP_ASYNC);
+}
+
+PROCESS_THREAD(ecdsa_service_process, ev, data)
+{
+    static int status;
+
+    PROCESS_BEGIN();
+
+    while(1)
+    {
+        PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+
+        if(!g_current)
+        {
+            g_current = list_pop(g_queue);
+            if(!g_current)
+            {
+                continue;
+            }
+            g_current->state = ECDSA_JOB_RUNNING;
+            status = start(g_current);
+        }
+        else
+        {
+            status = step(g_current);
+        }
+
+        if(status == ECDSA_STEP_AGAIN)
+        {
+            /* Let queued events run, then come back for the next slot. */
+            if(!waits_for_backend(g_current))
+            {
+                ecdsa_service_poll();
+            }
+            continue;
+        }
+
+        g_current->result = status;
+        g_current->state = ECDSA_JOB_DONE;
+        process_post(g_current->owner, ecdsa_event_done, g_current);
+        g_current = NULL;
+        wipe_work();
+
+        if(list_head(g_queue))
+        {
+            ecdsa_service_poll();
+        }
+    }
+
+    PROCESS_END();
+}
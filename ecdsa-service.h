@@ -0,0 +1,186 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Crypto service process. Application processes submit sign, verify,
+*    recover and hash jobs; the service runs them one at a time in priority
+*    order, in small steps between other events, and posts ecdsa_event_done
+*    to the submitting process when each finishes.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __ECDSA_SERVICE_H
+#define __ECDSA_SERVICE_H
+
+#include "contiki.h"
+#include "ecdsa-engine.h"
+#include "ecdsa-pt.h"
+
+/* ECDSA_SERVICE_QUEUE_SIZE - Maximum number of jobs waiting to run.
+   Override with ECDSA_SERVICE_CONF_QUEUE_SIZE. */
+#ifdef ECDSA_SERVICE_CONF_QUEUE_SIZE
+#define ECDSA_SERVICE_QUEUE_SIZE ECDSA_SERVICE_CONF_QUEUE_SIZE
+#else
+#define ECDSA_SERVICE_QUEUE_SIZE 4
+#endif
+
+/* ECDSA_SERVICE_HASH_CHUNK - Message bytes hashed per scheduling slot by a
+   hash job. Override with ECDSA_SERVICE_CONF_HASH_CHUNK. */
+#ifdef ECDSA_SERVICE_CONF_HASH_CHUNK
+#define ECDSA_SERVICE_HASH_CHUNK ECDSA_SERVICE_CONF_HASH_CHUNK
+#else
+#define ECDSA_SERVICE_HASH_CHUNK 512
+#endif
+
+typedef enum
+{
+    ECDSA_JOB_SIGN,
+    ECDSA_JOB_VERIFY,
+    ECDSA_JOB_RECOVER,
+    ECDSA_JOB_HASH
+} ecdsa_job_type_t;
+
+typedef enum
+{
+    ECDSA_JOB_IDLE,
+    ECDSA_JOB_QUEUED,
+    ECDSA_JOB_RUNNING,
+    ECDSA_JOB_DONE,
+    ECDSA_JOB_CANCELLED
+} ecdsa_job_state_t;
+
+/**
+ *  A job, owned by the submitter. It and every buffer it points to must
+ *  stay valid until ecdsa_event_done arrives for it or it is cancelled.
+ */
+typedef struct ecdsa_job
+{
+    struct ecdsa_job* next;     /* queue link, must be first */
+    struct process* owner;
+    uint8_t type;               /* ecdsa_job_type_t */
+    uint8_t priority;           /* higher runs first */
+    uint8_t state;              /* ecdsa_job_state_t */
+    int result;                 /* 0 - success, once done */
+    union
+    {
+        struct
+        {
+            const uint8_t* priv_key;
+            const uint8_t* hash;
+            ecdsa_signature_t* sig;
+        } sign;
+        struct
+        {
+            const uint8_t* pub_key;
+            const uint8_t* hash;
+            const ecdsa_signature_t* sig;
+        } verify;
+        struct
+        {
+            const uint8_t* hash;
+            const ecdsa_signature_t* sig;
+            int recid;
+            uint8_t* pub_key;
+        } recover;
+        struct
+        {
+            const uint8_t* message;
+            uint32_t len;
+            uint8_t* hash;
+        } hash;
+    } op;
+} ecdsa_job_t;
+
+PROCESS_NAME(ecdsa_service_process);
+
+/**
+ *  Start the service process. ecdsa_init() must have been called.
+ */
+void ecdsa_service_init();
+
+/**
+ *  Queue a job to sign a hash. ecdsa_event_done is posted to the calling
+ *  process with the job as data; job->result is 0 if sig was written.
+ *  Jobs of equal priority run in submission order. A running job is not
+ *  preempted by a higher priority one.
+ *
+ *  @return 0 - queued, -1 if the queue is full or the job is in use.
+ */
+int ecdsa_service_sign(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t priv_key[32],
+    const uint8_t hash[32],
+    ecdsa_signature_t* sig);
+
+/**
+ *  Queue a job to verify a signature over a hash. job->result is 0 if valid.
+ */
+int ecdsa_service_verify(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t pub_key[64],
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig);
+
+/**
+ *  Queue a job to recover the signer's public key.
+ */
+int ecdsa_service_recover(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t hash[32],
+    const ecdsa_signature_t* sig,
+    int recid,
+    uint8_t pub_key[64]);
+
+/**
+ *  Queue a job to SHA-256 a message, ECDSA_SERVICE_HASH_CHUNK bytes at a time.
+ */
+int ecdsa_service_hash(
+    ecdsa_job_t* job,
+    uint8_t priority,
+    const uint8_t* message,
+    uint32_t len,
+    uint8_t hash[32]);
+
+/**
+ *  Withdraw a queued or running job. No event is posted for it.
+ *
+ *  @return 0 - cancelled, -1 if it was not queued or running.
+ */
+int ecdsa_service_cancel(ecdsa_job_t* job);
+
+/**
+ *  Wake the service, e.g. from a backend's completion callback when an
+ *  ECDSA_CAP_ASYNC operation finishes. Safe to call from interrupt context.
+ */
+void ecdsa_service_poll();
+
+#endif
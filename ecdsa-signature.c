@@ -0,0 +1,320 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    ECDSA signature encodings: compact, EOS compact with recovery byte, DER.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "ecdsa-signature.h"
+
+/* EOS (fc) recovery byte: 27, plus 4 for a compressed public key, plus recid. */
+#define EOS_RECID_BASE      27
+#define EOS_RECID_COMPRESSED 4
+
+#define DER_SEQUENCE        0x30
+#define DER_INTEGER         0x02
+
+/* Group order n and n/2 of each curve, big-endian. */
+static const uint8_t secp256k1_n[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B,
+    0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41
+};
+
+static const uint8_t secp256k1_half_n[32] = {
+    0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x5D, 0x57, 0x6E, 0x73, 0x57, 0xA4, 0x50, 0x1D,
+    0xDF, 0xE9, 0x2F, 0x46, 0x68, 0x1B, 0x20, 0xA0
+};
+
+static const uint8_t secp256r1_n[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84,
+    0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51
+};
+
+static const uint8_t secp256r1_half_n[32] = {
+    0x7F, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00,
+    0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xDE, 0x73, 0x7D, 0x56, 0xD3, 0x8B, 0xCF, 0x42,
+    0x79, 0xDC, 0xE5, 0x61, 0x7E, 0x31, 0x92, 0xA8
+};
+
+static const uint8_t* curve_order(ecdsa_curve_t curve)
+{
+    return (curve == ECDSA_CURVE_SECP256R1) ? secp256r1_n : secp256k1_n;
+}
+
+static const uint8_t* curve_half_order(ecdsa_curve_t curve)
+{
+    return (curve == ECDSA_CURVE_SECP256R1) ? secp256r1_half_n : secp256k1_half_n;
+}
+
+static int is_zero(const uint8_t x[32])
+{
+    uint8_t acc = 0;
+    int i;
+    for(i = 0; i < 32; ++i)
+    {
+        acc |= x[i];
+    }
+    return acc == 0;
+}
+
+/* Range check 1 <= x <= max for big-endian 32-byte values. */
+static int in_range(const uint8_t x[32], const uint8_t max[32])
+{
+    return !is_zero(x) && memcmp(x, max, 32) <= 0;
+}
+
+int ecdsa_sig_is_low_s(const ecdsa_signature_t* sig, ecdsa_curve_t curve)
+{
+    return memcmp(sig->s, curve_half_order(curve), 32) <= 0;
+}
+
+int ecdsa_sig_normalize_s(ecdsa_signature_t* sig, ecdsa_curve_t curve)
+{
+    const uint8_t* n = curve_order(curve);
+    int borrow = 0;
+    int i;
+
+    if(ecdsa_sig_is_low_s(sig, curve))
+    {
+        return 0;
+    }
+
+    /* s = n - s */
+    for(i = 31; i >= 0; --i)
+    {
+        int d = (int)n[i] - (int)sig->s[i] - borrow;
+        borrow = (d < 0);
+        sig->s[i] = (uint8_t)d;
+    }
+    return 1;
+}
+
+int ecdsa_sig_check(const ecdsa_signature_t* sig, ecdsa_curve_t curve)
+{
+    /* r < n, and 1 <= s <= n/2 which also covers s < n. */
+    uint8_t n_minus_1[32];
+
+    memcpy(n_minus_1, curve_order(curve), 32);
+    n_minus_1[31] -= 1;  /* n is odd, no borrow */
+
+    if(!in_range(sig->r, n_minus_1) || !in_range(sig->s, curve_half_order(curve)))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int ecdsa_sig_is_eos_canonical(const ecdsa_signature_t* sig)
+{
+    return !(sig->r[0] & 0x80) && !(sig->r[0] == 0 && !(sig->r[1] & 0x80))
+        && !(sig->s[0] & 0x80) && !(sig->s[0] == 0 && !(sig->s[1] & 0x80));
+}
+
+int ecdsa_sig_eos_set_recid(uint8_t eos[ECDSA_SIG_EOS_SIZE], int recid)
+{
+    if(recid < 0 || recid > 3)
+    {
+        return -1;
+    }
+    eos[0] = (uint8_t)(EOS_RECID_BASE + EOS_RECID_COMPRESSED + recid);
+    return 0;
+}
+
+int ecdsa_sig_eos_parse(const uint8_t eos[ECDSA_SIG_EOS_SIZE], ecdsa_curve_t curve)
+{
+    /* Accept both the compressed (31..34) and uncompressed (27..30) forms. */
+    if(eos[0] < EOS_RECID_BASE || eos[0] > EOS_RECID_BASE + EOS_RECID_COMPRESSED + 3)
+    {
+        return -1;
+    }
+    if(ecdsa_sig_check((const ecdsa_signature_t*)(eos + 1), curve) != 0)
+    {
+        return -1;
+    }
+    return (eos[0] - EOS_RECID_BASE) & 3;
+}
+
+/* Write one DER INTEGER for a 32-byte big-endian value. */
+static uint8_t* der_put_integer(uint8_t* p, const uint8_t x[32])
+{
+    uint32_t skip = 0;
+    uint32_t len;
+
+    while(skip < 31 && x[skip] == 0)
+    {
+        ++skip;
+    }
+    len = 32 - skip;
+
+    *p++ = DER_INTEGER;
+    if(x[skip] & 0x80)
+    {
+        *p++ = (uint8_t)(len + 1);
+        *p++ = 0;
+    }
+    else
+    {
+        *p++ = (uint8_t)len;
+    }
+    memcpy(p, x + skip, len);
+    return p + len;
+}
+
+static uint32_t der_integer_size(const uint8_t x[32])
+{
+    uint32_t skip = 0;
+
+    while(skip < 31 && x[skip] == 0)
+    {
+        ++skip;
+    }
+    return 2 + (32 - skip) + ((x[skip] & 0x80) ? 1 : 0);
+}
+
+int ecdsa_sig_to_der(const ecdsa_signature_t* sig, uint8_t* out, uint32_t out_size)
+{
+    uint32_t body = der_integer_size(sig->r) + der_integer_size(sig->s);
+    uint8_t* p = out;
+
+    if(out_size < body + 2)
+    {
+        return -1;
+    }
+
+    *p++ = DER_SEQUENCE;
+    *p++ = (uint8_t)body;
+    p = der_put_integer(p, sig->r);
+    p = der_put_integer(p, sig->s);
+    return (int)(p - out);
+}
+
+/* Read one DER INTEGER at *pp, which must lie before end. On success *pp is
+   advanced past it and the value is returned without its sign byte. */
+static int der_get_integer(
+    const uint8_t** pp,
+    const uint8_t* end,
+    const uint8_t** value,
+    uint32_t* value_len)
+{
+    const uint8_t* p = *pp;
+    uint32_t len;
+
+    if(end - p < 3 || p[0] != DER_INTEGER)
+    {
+        return -1;
+    }
+    len = p[1];
+    p += 2;
+
+    /* Short-form length only, and the content must fit. */
+    if(len == 0 || len > 33 || (uint32_t)(end - p) < len)
+    {
+        return -1;
+    }
+    /* Negative */
+    if(p[0] & 0x80)
+    {
+        return -1;
+    }
+    /* Minimal encoding: a leading zero is only allowed before a high bit. */
+    if(len > 1 && p[0] == 0)
+    {
+        if(!(p[1] & 0x80))
+        {
+            return -1;
+        }
+        ++p;
+        --len;
+    }
+    if(len > 32)
+    {
+        return -1;
+    }
+
+    *value = p;
+    *value_len = len;
+    *pp = p + len;
+    return 0;
+}
+
+int ecdsa_sig_der_parse(const uint8_t* der, uint32_t len, ecdsa_der_view_t* view)
+{
+    const uint8_t* p = der + 2;
+    const uint8_t* end = der + len;
+
+    if(len < 8 || len > ECDSA_SIG_DER_MAX_SIZE)
+    {
+        return -1;
+    }
+    if(der[0] != DER_SEQUENCE || der[1] != len - 2)
+    {
+        return -1;
+    }
+    if(der_get_integer(&p, end, &view->r, &view->r_len) != 0 ||
+       der_get_integer(&p, end, &view->s, &view->s_len) != 0)
+    {
+        return -1;
+    }
+    /* No trailing bytes inside the sequence. */
+    if(p != end)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int ecdsa_sig_from_der(
+    const uint8_t* der,
+    uint32_t len,
+    ecdsa_curve_t curve,
+    ecdsa_signature_t* sig)
+{
+    ecdsa_der_view_t view;
+
+    if(ecdsa_sig_der_parse(der, len, &view) != 0)
+    {
+        return -1;
+    }
+
+    memset(sig, 0, sizeof(*sig));
+    memcpy(sig->r + 32 - view.r_len, view.r, view.r_len);
+    memcpy(sig->s + 32 - view.s_len, view.s, view.s_len);
+
+    return ecdsa_sig_check(sig, curve);
+}
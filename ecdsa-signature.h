@@ -0,0 +1,139 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    ECDSA signature encodings: 64-byte compact (r || s), EOS 65-byte compact
+*    with a recovery byte, and ASN.1 DER. Encoders write straight into the
+*    caller's buffer and the parsers work on the received bytes where they
+*    lie; r and s are range and low-S checked while parsing.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __ECDSA_SIGNATURE_H
+#define __ECDSA_SIGNATURE_H
+
+#include <stdint.h>
+#include "ecdsa-engine.h"
+
+#define ECDSA_SIG_COMPACT_SIZE  64  /* r || s, big-endian */
+#define ECDSA_SIG_EOS_SIZE      65  /* recovery byte || r || s */
+#define ECDSA_SIG_DER_MAX_SIZE  72  /* SEQUENCE { INTEGER r, INTEGER s } */
+
+/* ecdsa_signature_t is laid out exactly as the compact form. */
+typedef char ecdsa_sig_compact_layout_check[(sizeof(ecdsa_signature_t) == ECDSA_SIG_COMPACT_SIZE) ? 1 : -1];
+
+/**
+ *  View a 64-byte compact buffer as a signature without copying.
+ */
+#define ecdsa_sig_compact_view(compact) ((ecdsa_signature_t*)(compact))
+
+/**
+ *  View the r || s part of a 65-byte EOS signature buffer as a signature, so
+ *  the engine can sign directly into the buffer that goes on the wire.
+ */
+#define ecdsa_sig_eos_view(eos) ((ecdsa_signature_t*)((eos) + 1))
+
+/**
+ *  Borrowed view of the integers inside a DER signature.
+ *  r and s point into the DER buffer, without leading zero bytes.
+ */
+typedef struct
+{
+    const uint8_t* r;
+    uint32_t r_len;
+    const uint8_t* s;
+    uint32_t s_len;
+} ecdsa_der_view_t;
+
+/**
+ *  Whether s is at most n/2, the form required by most verifiers.
+ */
+int ecdsa_sig_is_low_s(const ecdsa_signature_t* sig, ecdsa_curve_t curve);
+
+/**
+ *  Replace a high s with n - s. This flips the parity of the recovery id.
+ *
+ *  @return 1 if s was changed, 0 if it was already low.
+ */
+int ecdsa_sig_normalize_s(ecdsa_signature_t* sig, ecdsa_curve_t curve);
+
+/**
+ *  Check a signature in compact form: r and s in [1, n-1] and s low.
+ *
+ *  @return 0 - valid, -1 otherwise.
+ */
+int ecdsa_sig_check(const ecdsa_signature_t* sig, ecdsa_curve_t curve);
+
+/**
+ *  EOS canonical form (as produced by eosio's K1 signer): neither r nor s
+ *  would need a DER sign byte or could be written shorter than 32 bytes.
+ */
+int ecdsa_sig_is_eos_canonical(const ecdsa_signature_t* sig);
+
+/**
+ *  Set the recovery byte of a 65-byte EOS signature (compressed key form).
+ *
+ *  @return 0 - success, -1 if recid is not 0..3.
+ */
+int ecdsa_sig_eos_set_recid(uint8_t eos[ECDSA_SIG_EOS_SIZE], int recid);
+
+/**
+ *  Check a 65-byte EOS signature in place and extract its recovery id.
+ *
+ *  @return recovery id 0..3, -1 on a bad recovery byte or r/s out of range.
+ */
+int ecdsa_sig_eos_parse(const uint8_t eos[ECDSA_SIG_EOS_SIZE], ecdsa_curve_t curve);
+
+/**
+ *  DER-encode a signature into out.
+ *
+ *  @return encoded length, -1 if out_size is too small.
+ */
+int ecdsa_sig_to_der(const ecdsa_signature_t* sig, uint8_t* out, uint32_t out_size);
+
+/**
+ *  Strictly parse a DER signature without copying it: exact lengths, minimal
+ *  positive INTEGERs, no trailing bytes.
+ *
+ *  @return 0 - success, -1 on malformed input.
+ */
+int ecdsa_sig_der_parse(const uint8_t* der, uint32_t len, ecdsa_der_view_t* view);
+
+/**
+ *  Parse a DER signature into compact form, rejecting out-of-range or high s.
+ *
+ *  @return 0 - success, -1 on malformed input or a non-canonical signature.
+ */
+int ecdsa_sig_from_der(
+    const uint8_t* der,
+    uint32_t len,
+    ecdsa_curve_t curve,
+    ecdsa_signature_t* sig);
+
+#endif
@@ -0,0 +1,143 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Stack high-water measurement for the crypto paths.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include "ecdsa-stack.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
+
+#if ECDSA_STACK_PROFILE
+
+#define STACK_PATTERN 0xA5
+
+/* Lowest address of the painted region. */
+static uintptr_t g_region;
+
+/* The painted array occupies the stack just below the caller's frame, where
+   the frames of the measured calls will later go. */
+__attribute__((noinline)) void ecdsa_stack_paint()
+{
+    volatile uint8_t region[ECDSA_STACK_PAINT_SIZE];
+    uint32_t i;
+
+    for(i = 0; i < sizeof(region); i++)
+    {
+        region[i] = STACK_PATTERN;
+    }
+    g_region = (uintptr_t)region;
+}
+
+__attribute__((noinline)) uint32_t ecdsa_stack_used()
+{
+    const volatile uint8_t* region = (const volatile uint8_t*)g_region;
+    uint32_t i;
+
+    /* The stack grows down: the deepest write is the lowest changed byte. */
+    for(i = 0; i < ECDSA_STACK_PAINT_SIZE && region[i] == STACK_PATTERN; i++)
+    {
+    }
+    return ECDSA_STACK_PAINT_SIZE - i;
+}
+
+/* Inputs for the measured calls; the values do not change the stack depth. */
+static const uint8_t g_priv_key[32] = {
+    0xC9, 0xAF, 0xA9, 0xD8, 0x45, 0xBA, 0x75, 0x16, 0x6B, 0x5C, 0x21, 0x57, 0x67, 0xB1, 0xD6, 0x93,
+    0x4E, 0x50, 0xC3, 0xDB, 0x36, 0xE8, 0x9B, 0x12, 0x7B, 0x8A, 0x62, 0x2B, 0x12, 0x0F, 0x67, 0x21 };
+static const uint8_t g_message[128];
+
+int ecdsa_stack_measure(
+    const ecdsa_engine_backend_t* b,
+    ecdsa_stack_usage_t* usage)
+{
+    uint8_t pub_key[64];
+    uint8_t hash[32];
+    uint8_t k[32];
+    uint8_t r[32];
+    uint8_t s[32];
+    int status = 0;
+
+    usage->keygen = 0;
+    usage->sign = 0;
+    usage->verify = 0;
+    usage->hash = 0;
+
+    if(b->hash)
+    {
+        ecdsa_stack_paint();
+        status |= b->hash(g_message, sizeof(g_message), hash);
+        usage->hash = ecdsa_stack_used();
+    }
+    else
+    {
+        sha256(g_message, sizeof(g_message), hash);
+    }
+
+    if(b->get_pubkey)
+    {
+        ecdsa_stack_paint();
+        status |= b->get_pubkey(g_priv_key, pub_key);
+        usage->keygen = ecdsa_stack_used();
+    }
+    else
+    {
+        /* Verify needs the key from whichever backend can derive it. */
+        status |= ecdsa_get_pubkey(g_priv_key, pub_key);
+    }
+
+    if(!b->random || b->random(k) != 0)
+    {
+        k[0] = 1;
+        for(int i = 1; i < 32; i++)
+        {
+            k[i] = 0;
+        }
+    }
+
+    if(b->sign)
+    {
+        ecdsa_stack_paint();
+        status |= b->sign(g_priv_key, k, hash, r, s);
+        usage->sign = ecdsa_stack_used();
+    }
+
+    if(b->verify && b->sign)
+    {
+        ecdsa_stack_paint();
+        status |= b->verify(pub_key, hash, r, s);
+        usage->verify = ecdsa_stack_used();
+    }
+
+    return status ? -1 : 0;
+}
+
+#endif /* ECDSA_STACK_PROFILE */
@@ -0,0 +1,99 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Stack high-water measurement for the crypto paths. The region below the
+*    caller's stack pointer is painted with a pattern before an operation and
+*    scanned afterwards for the deepest byte it overwrote.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __ECDSA_STACK_H
+#define __ECDSA_STACK_H
+
+#include <stdint.h>
+#include "ecdsa-engine.h"
+
+/* ECDSA_STACK_PROFILE - If enabled (defined as nonzero), the stack
+   measurement functions below are built. Leave disabled in production: each
+   measurement paints ECDSA_STACK_PAINT_SIZE bytes of stack.
+   Override with ECDSA_STACK_CONF_PROFILE. */
+#ifdef ECDSA_STACK_CONF_PROFILE
+#define ECDSA_STACK_PROFILE ECDSA_STACK_CONF_PROFILE
+#else
+#define ECDSA_STACK_PROFILE 0
+#endif
+
+/* ECDSA_STACK_PAINT_SIZE - Bytes painted below the caller's stack pointer.
+   Must be larger than the deepest operation measured and smaller than the
+   free stack at the call site. Override with ECDSA_STACK_CONF_PAINT_SIZE. */
+#ifdef ECDSA_STACK_CONF_PAINT_SIZE
+#define ECDSA_STACK_PAINT_SIZE ECDSA_STACK_CONF_PAINT_SIZE
+#else
+#define ECDSA_STACK_PAINT_SIZE 2048
+#endif
+
+#if ECDSA_STACK_PROFILE
+
+/* Peak stack use of each operation on one backend, in bytes. 0 if the backend
+   does not provide the operation. */
+typedef struct
+{
+    uint32_t keygen;
+    uint32_t sign;
+    uint32_t verify;
+    uint32_t hash;
+} ecdsa_stack_usage_t;
+
+/**
+ *  Paint the stack below the caller's frame. Call immediately before the
+ *  code to be measured, from the same function.
+ */
+void ecdsa_stack_paint();
+
+/**
+ *  Bytes of the painted region overwritten since ecdsa_stack_paint().
+ *  Interrupts taken on the same stack are included. A result equal to
+ *  ECDSA_STACK_PAINT_SIZE means the region was too small.
+ */
+uint32_t ecdsa_stack_used();
+
+/**
+ *  Measure keygen (public key derivation), sign, verify and hash on a backend
+ *  for the current curve. The backend must already be initialized.
+ *
+ *  @return 0 - success, -1 if an operation failed.
+ */
+int ecdsa_stack_measure(
+    const ecdsa_engine_backend_t* backend,
+    ecdsa_stack_usage_t* usage);
+
+#endif /* ECDSA_STACK_PROFILE */
+
+#endif // __ECDSA_STACK_H
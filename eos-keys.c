@@ -0,0 +1,475 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    EOS key and signature text codec.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "eos-keys.h"
+#include "ecdsa-engines/sw/sha256.h"
+#include "ecdsa-engines/sw/ripemd160.h"
+#include "ecdsa-engines/sw/uecc.h"
+
+/* The big-number conversion works on limbs rather than single bytes: every
+   pass over the number peels off several base58 digits at once. 64-bit hosts
+   use 32-bit limbs and a 58^5 radix; 32-bit MCUs use 16-bit limbs and a 58^2
+   radix so that every step stays within a native 32-bit divide. */
+#if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint32_t b58_limb_t;
+typedef uint64_t b58_dlimb_t;
+#define B58_LIMB_BITS    32
+#define B58_RADIX        656356768u /* 58^5 */
+#define B58_RADIX_DIGITS 5
+#else
+typedef uint16_t b58_limb_t;
+typedef uint32_t b58_dlimb_t;
+#define B58_LIMB_BITS    16
+#define B58_RADIX        3364u /* 58^2 */
+#define B58_RADIX_DIGITS 2
+#endif
+
+#define B58_LIMB_BYTES (B58_LIMB_BITS / 8)
+
+/* Largest binary payload handled: a signature plus its checksum. */
+#define B58_MAX_BYTES  (EOS_SIGNATURE_SIZE + 4)
+#define B58_MAX_LIMBS  ((B58_MAX_BYTES + B58_LIMB_BYTES - 1) / B58_LIMB_BYTES)
+/* log(256)/log(58) < 1.37, rounded up to whole radix chunks */
+#define B58_MAX_DIGITS (((B58_MAX_BYTES * 137 + 99) / 100) + B58_RADIX_DIGITS)
+
+#define EOS_CHECKSUM_SIZE 4
+
+static const char b58_alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+static const int8_t b58_map[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1,
+    -1,  9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+    22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+    -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1 };
+
+static const char* const key_suffix[] = { "K1", "R1" };
+
+int eos_base58_encode(const uint8_t* data, uint32_t len, char* out, uint32_t out_size)
+{
+    b58_limb_t limbs[B58_MAX_LIMBS];
+    uint8_t digits[B58_MAX_DIGITS];
+    uint32_t zeros = 0;
+    uint32_t ndigits = 0;
+    uint32_t nlimbs, start, i, pad;
+
+    while(zeros < len && data[zeros] == 0)
+    {
+        ++zeros;
+    }
+    data += zeros;
+    len -= zeros;
+    if(len > B58_MAX_BYTES)
+    {
+        return -1;
+    }
+
+    /* Big-endian limbs, the most significant one possibly partial. */
+    nlimbs = (len + B58_LIMB_BYTES - 1) / B58_LIMB_BYTES;
+    pad = nlimbs * B58_LIMB_BYTES - len;
+    memset(limbs, 0, sizeof(limbs));
+    for(i = 0; i < len; ++i)
+    {
+        uint32_t pos = i + pad;
+        limbs[pos / B58_LIMB_BYTES] = (b58_limb_t)((limbs[pos / B58_LIMB_BYTES] << 8) | data[i]);
+    }
+
+    /* Repeated division by the radix; each remainder yields several digits. */
+    start = 0;
+    while(start < nlimbs)
+    {
+        b58_dlimb_t rem = 0;
+        for(i = start; i < nlimbs; ++i)
+        {
+            b58_dlimb_t cur = (rem << B58_LIMB_BITS) | limbs[i];
+            limbs[i] = (b58_limb_t)(cur / B58_RADIX);
+            rem = cur % B58_RADIX;
+        }
+        while(start < nlimbs && limbs[start] == 0)
+        {
+            ++start;
+        }
+        for(i = 0; i < B58_RADIX_DIGITS; ++i)
+        {
+            digits[ndigits++] = (uint8_t)(rem % 58);
+            rem /= 58;
+        }
+    }
+    while(ndigits > 0 && digits[ndigits - 1] == 0)
+    {
+        --ndigits;
+    }
+
+    if(zeros + ndigits + 1 > out_size)
+    {
+        return -1;
+    }
+    for(i = 0; i < zeros; ++i)
+    {
+        *out++ = '1';
+    }
+    for(i = 0; i < ndigits; ++i)
+    {
+        *out++ = b58_alphabet[digits[ndigits - 1 - i]];
+    }
+    *out = '\0';
+
+    return (int)(zeros + ndigits);
+}
+
+int eos_base58_decode(const char* str, uint32_t len, uint8_t* out, uint32_t out_size)
+{
+    b58_limb_t limbs[B58_MAX_LIMBS + 1];    /* little-endian */
+    uint32_t nlimbs = 0;
+    uint32_t zeros = 0;
+    uint32_t nbytes, i, k;
+
+    while(zeros < len && str[zeros] == '1')
+    {
+        ++zeros;
+    }
+
+    /* Multiply-accumulate a chunk of digits at a time; the first chunk takes
+       the remainder so that the rest are whole radix chunks. */
+    i = zeros;
+    while(i < len)
+    {
+        uint32_t chunk = (len - i) % B58_RADIX_DIGITS;
+        b58_dlimb_t mul = 1;
+        b58_dlimb_t carry = 0;
+
+        if(chunk == 0 || i != zeros)
+        {
+            chunk = B58_RADIX_DIGITS;
+        }
+        for(k = 0; k < chunk; ++k, ++i)
+        {
+            uint8_t c = (uint8_t)str[i];
+            if(c >= 128 || b58_map[c] < 0)
+            {
+                return -1;
+            }
+            carry = carry * 58 + (b58_dlimb_t)b58_map[c];
+            mul *= 58;
+        }
+
+        for(k = 0; k < nlimbs; ++k)
+        {
+            b58_dlimb_t cur = (b58_dlimb_t)limbs[k] * mul + carry;
+            limbs[k] = (b58_limb_t)cur;
+            carry = cur >> B58_LIMB_BITS;
+        }
+        while(carry)
+        {
+            if(nlimbs > B58_MAX_LIMBS)
+            {
+                return -1;
+            }
+            limbs[nlimbs++] = (b58_limb_t)carry;
+            carry >>= B58_LIMB_BITS;
+        }
+    }
+
+    /* Significant bytes of the number. */
+    nbytes = nlimbs * B58_LIMB_BYTES;
+    while(nbytes > 0 && ((limbs[(nbytes - 1) / B58_LIMB_BYTES] >> (8 * ((nbytes - 1) % B58_LIMB_BYTES))) & 0xFF) == 0)
+    {
+        --nbytes;
+    }
+
+    if(zeros + nbytes > out_size)
+    {
+        return -1;
+    }
+    memset(out, 0, zeros);
+    for(i = 0; i < nbytes; ++i)
+    {
+        uint32_t pos = nbytes - 1 - i;
+        out[zeros + i] = (uint8_t)(limbs[pos / B58_LIMB_BYTES] >> (8 * (pos % B58_LIMB_BYTES)));
+    }
+
+    return (int)(zeros + nbytes);
+}
+
+/* RIPEMD-160 checksum over the payload and the key type suffix (if any). */
+static void eos_checksum(const uint8_t* data, uint32_t len, const char* suffix, uint8_t check[EOS_CHECKSUM_SIZE])
+{
+    ripemd160_ctx_t ctx;
+    uint8_t digest[RIPEMD160_DIGEST_SIZE];
+
+    ripemd160_init(&ctx);
+    ripemd160_update(&ctx, data, len);
+    if(suffix)
+    {
+        ripemd160_update(&ctx, (const uint8_t*)suffix, 2);
+    }
+    ripemd160_final(&ctx, digest);
+    memcpy(check, digest, EOS_CHECKSUM_SIZE);
+}
+
+/* Legacy WIF checksum: first four bytes of sha256(sha256(payload)). */
+static void wif_checksum(const uint8_t* data, uint32_t len, uint8_t check[EOS_CHECKSUM_SIZE])
+{
+    uint8_t digest[SHA256_DIGEST_SIZE];
+
+    sha256(data, len, digest);
+    sha256(digest, sizeof(digest), digest);
+    memcpy(check, digest, EOS_CHECKSUM_SIZE);
+}
+
+/* "<prefix><base58(payload || checksum)>" */
+static int encode_checked(const char* prefix, const uint8_t* payload, uint32_t len,
+    const char* suffix, char* out, uint32_t out_size)
+{
+    uint8_t buf[B58_MAX_BYTES];
+    uint32_t plen = strlen(prefix);
+
+    if(plen >= out_size)
+    {
+        return -1;
+    }
+    memcpy(buf, payload, len);
+    eos_checksum(payload, len, suffix, buf + len);
+    memcpy(out, prefix, plen);
+
+    return (eos_base58_encode(buf, len + EOS_CHECKSUM_SIZE, out + plen, out_size - plen) < 0) ? -1 : 0;
+}
+
+/* Decode the base58 body of a string into exactly len payload bytes plus checksum. */
+static int decode_body(const char* body, uint8_t* buf, uint32_t len)
+{
+    uint32_t n = strlen(body);
+    int result = eos_base58_decode(body, n, buf, len + EOS_CHECKSUM_SIZE);
+    return (result == (int)(len + EOS_CHECKSUM_SIZE)) ? 0 : -1;
+}
+
+/* Parse "<kind>_K1_" / "<kind>_R1_"; returns the body or NULL. */
+static const char* parse_prefix(const char* str, const char* kind, eos_key_type_t* type)
+{
+    if(strncmp(str, kind, 3) != 0 || str[3] != '_')
+    {
+        return NULL;
+    }
+    if(strncmp(str + 4, key_suffix[EOS_KEY_K1], 2) == 0)
+    {
+        *type = EOS_KEY_K1;
+    }
+    else if(strncmp(str + 4, key_suffix[EOS_KEY_R1], 2) == 0)
+    {
+        *type = EOS_KEY_R1;
+    }
+    else
+    {
+        return NULL;
+    }
+    return (str[6] == '_') ? str + 7 : NULL;
+}
+
+static int decode_checked(const char* str, const char* kind, uint8_t* payload, uint32_t len, eos_key_type_t* type)
+{
+    uint8_t buf[B58_MAX_BYTES];
+    uint8_t check[EOS_CHECKSUM_SIZE];
+    const char* body = parse_prefix(str, kind, type);
+
+    if(!body || decode_body(body, buf, len) != 0)
+    {
+        return -1;
+    }
+    eos_checksum(buf, len, key_suffix[*type], check);
+    if(memcmp(check, buf + len, EOS_CHECKSUM_SIZE) != 0)
+    {
+        return -1;
+    }
+    memcpy(payload, buf, len);
+    return 0;
+}
+
+int eos_pubkey_compressed_to_string(
+    const uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE],
+    eos_key_type_t type,
+    char* out,
+    uint32_t out_size)
+{
+    char prefix[] = "PUB_K1_";
+    memcpy(prefix + 4, key_suffix[type], 2);
+    return encode_checked(prefix, compressed, EOS_PUB_KEY_COMPRESSED_SIZE, key_suffix[type], out, out_size);
+}
+
+int eos_pubkey_compressed_from_string(
+    const char* str,
+    uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE],
+    eos_key_type_t* type)
+{
+    if(strncmp(str, "EOS", 3) == 0)
+    {
+        uint8_t buf[EOS_PUB_KEY_COMPRESSED_SIZE + EOS_CHECKSUM_SIZE];
+        uint8_t check[EOS_CHECKSUM_SIZE];
+
+        if(decode_body(str + 3, buf, EOS_PUB_KEY_COMPRESSED_SIZE) != 0)
+        {
+            return -1;
+        }
+        eos_checksum(buf, EOS_PUB_KEY_COMPRESSED_SIZE, NULL, check);
+        if(memcmp(check, buf + EOS_PUB_KEY_COMPRESSED_SIZE, EOS_CHECKSUM_SIZE) != 0)
+        {
+            return -1;
+        }
+        memcpy(compressed, buf, EOS_PUB_KEY_COMPRESSED_SIZE);
+        *type = EOS_KEY_K1;
+        return 0;
+    }
+    return decode_checked(str, "PUB", compressed, EOS_PUB_KEY_COMPRESSED_SIZE, type);
+}
+
+/* Key type of the curve the software engine is currently using. */
+static eos_key_type_t current_key_type(void)
+{
+    return (uECC_get_curve() == uECC_curve_secp256r1()) ? EOS_KEY_R1 : EOS_KEY_K1;
+}
+
+int eos_pubkey_to_string(const uint8_t pub_key[64], char* out, uint32_t out_size)
+{
+    uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE];
+    uECC_compress(pub_key, compressed);
+    return eos_pubkey_compressed_to_string(compressed, current_key_type(), out, out_size);
+}
+
+int eos_pubkey_to_legacy_string(const uint8_t pub_key[64], char* out, uint32_t out_size)
+{
+    uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE];
+    uECC_compress(pub_key, compressed);
+    return encode_checked("EOS", compressed, EOS_PUB_KEY_COMPRESSED_SIZE, NULL, out, out_size);
+}
+
+int eos_pubkey_from_string(const char* str, uint8_t pub_key[64])
+{
+    uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE];
+    eos_key_type_t type;
+    uECC_Curve curve;
+    uECC_Curve saved;
+    uECC_Key key;
+    int result;
+
+    if(eos_pubkey_compressed_from_string(str, compressed, &type) != 0)
+    {
+        return -1;
+    }
+
+    /* Load on the key's own curve, whichever one the engine is using. The
+       load rejects an x that is not on the curve, which uECC_decompress
+       would turn into a meaningless point. */
+    curve = (type == EOS_KEY_R1) ? uECC_curve_secp256r1() : uECC_curve_secp256k1();
+    if(curve == NULL)
+    {
+        return -1;
+    }
+    saved = uECC_get_curve();
+    uECC_set_curve(curve);
+    result = uECC_key_load(&key, compressed, sizeof(compressed)) &&
+        uECC_key_export(&key, pub_key);
+    uECC_set_curve(saved);
+    return result ? 0 : -1;
+}
+
+int eos_privkey_to_string(
+    const uint8_t priv_key[EOS_PRIV_KEY_SIZE],
+    eos_key_type_t type,
+    char* out,
+    uint32_t out_size)
+{
+    char prefix[] = "PVT_K1_";
+    memcpy(prefix + 4, key_suffix[type], 2);
+    return encode_checked(prefix, priv_key, EOS_PRIV_KEY_SIZE, key_suffix[type], out, out_size);
+}
+
+int eos_privkey_to_wif(const uint8_t priv_key[EOS_PRIV_KEY_SIZE], char* out, uint32_t out_size)
+{
+    uint8_t buf[1 + EOS_PRIV_KEY_SIZE + EOS_CHECKSUM_SIZE];
+
+    buf[0] = 0x80;
+    memcpy(buf + 1, priv_key, EOS_PRIV_KEY_SIZE);
+    wif_checksum(buf, 1 + EOS_PRIV_KEY_SIZE, buf + 1 + EOS_PRIV_KEY_SIZE);
+
+    return (eos_base58_encode(buf, sizeof(buf), out, out_size) < 0) ? -1 : 0;
+}
+
+int eos_privkey_from_string(
+    const char* str,
+    uint8_t priv_key[EOS_PRIV_KEY_SIZE],
+    eos_key_type_t* type)
+{
+    if(strncmp(str, "PVT_", 4) != 0)
+    {
+        uint8_t buf[1 + EOS_PRIV_KEY_SIZE + EOS_CHECKSUM_SIZE];
+        uint8_t check[EOS_CHECKSUM_SIZE];
+
+        if(decode_body(str, buf, 1 + EOS_PRIV_KEY_SIZE) != 0 || buf[0] != 0x80)
+        {
+            return -1;
+        }
+        wif_checksum(buf, 1 + EOS_PRIV_KEY_SIZE, check);
+        if(memcmp(check, buf + 1 + EOS_PRIV_KEY_SIZE, EOS_CHECKSUM_SIZE) != 0)
+        {
+            return -1;
+        }
+        memcpy(priv_key, buf + 1, EOS_PRIV_KEY_SIZE);
+        *type = EOS_KEY_K1;
+        return 0;
+    }
+    return decode_checked(str, "PVT", priv_key, EOS_PRIV_KEY_SIZE, type);
+}
+
+int eos_signature_to_string(
+    const uint8_t sig[EOS_SIGNATURE_SIZE],
+    eos_key_type_t type,
+    char* out,
+    uint32_t out_size)
+{
+    char prefix[] = "SIG_K1_";
+    memcpy(prefix + 4, key_suffix[type], 2);
+    return encode_checked(prefix, sig, EOS_SIGNATURE_SIZE, key_suffix[type], out, out_size);
+}
+
+int eos_signature_from_string(
+    const char* str,
+    uint8_t sig[EOS_SIGNATURE_SIZE],
+    eos_key_type_t* type)
+{
+    return decode_checked(str, "SIG", sig, EOS_SIGNATURE_SIZE, type);
+}
@@ -0,0 +1,172 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    EOS key and signature text codec: PUB_K1_..., PVT_K1_..., SIG_K1_...
+*    strings (base58 with a RIPEMD-160 checksum) plus the legacy EOS... public
+*    key and WIF private key forms. No dynamic allocation; all output goes to
+*    caller buffers.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __EOS_KEYS_H
+#define __EOS_KEYS_H
+
+#include <stdint.h>
+
+typedef enum
+{
+    EOS_KEY_K1,     /* secp256k1 */
+    EOS_KEY_R1,     /* secp256r1 (NIST P-256) */
+} eos_key_type_t;
+
+#define EOS_PUB_KEY_COMPRESSED_SIZE  33
+#define EOS_PRIV_KEY_SIZE            32
+#define EOS_SIGNATURE_SIZE           65  /* recovery byte followed by r and s */
+
+/* String buffer sizes including the terminating NUL. */
+#define EOS_PUB_KEY_STR_SIZE   59   /* "PUB_K1_" + 51 base58 digits, or "EOS" + 51 */
+#define EOS_PRIV_KEY_STR_SIZE  58   /* "PVT_K1_" + 50 base58 digits, or 51 for WIF */
+#define EOS_SIGNATURE_STR_SIZE 103  /* "SIG_K1_" + 95 base58 digits */
+
+/**
+ *  Base58 (bitcoin alphabet) encode len bytes into a NUL-terminated string.
+ *
+ *  @return number of characters written (excluding the NUL), -1 if out_size is too small.
+ */
+int eos_base58_encode(const uint8_t* data, uint32_t len, char* out, uint32_t out_size);
+
+/**
+ *  Base58 decode exactly len characters of str into out.
+ *
+ *  @return number of bytes decoded, -1 on an invalid character or if out_size is too small.
+ */
+int eos_base58_decode(const char* str, uint32_t len, uint8_t* out, uint32_t out_size);
+
+/**
+ *  Format a compressed public key as "PUB_K1_..." / "PUB_R1_...".
+ *
+ *  @return 0 - success
+ */
+int eos_pubkey_compressed_to_string(
+    const uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE],
+    eos_key_type_t type,
+    char* out,
+    uint32_t out_size);
+
+/**
+ *  Parse "PUB_K1_...", "PUB_R1_..." or legacy "EOS..." into a compressed key.
+ *
+ *  @param(type) [out] key type named by the string; legacy keys are K1.
+ *
+ *  @return 0 - success, -1 on a malformed string or checksum mismatch.
+ */
+int eos_pubkey_compressed_from_string(
+    const char* str,
+    uint8_t compressed[EOS_PUB_KEY_COMPRESSED_SIZE],
+    eos_key_type_t* type);
+
+/**
+ *  Format a 64-byte (x, y) public key of the engine's current curve as
+ *  "PUB_K1_..." or "PUB_R1_...".
+ *  The key is compressed with uECC_compress.
+ *
+ *  @return 0 - success
+ */
+int eos_pubkey_to_string(const uint8_t pub_key[64], char* out, uint32_t out_size);
+
+/**
+ *  Format a 64-byte (x, y) public key in the legacy "EOS..." form.
+ *
+ *  @return 0 - success
+ */
+int eos_pubkey_to_legacy_string(const uint8_t pub_key[64], char* out, uint32_t out_size);
+
+/**
+ *  Parse a K1 or R1 public key string into the 64-byte (x, y) form used by
+ *  ecdsa_verify. The key is loaded with uECC_key_load on its own curve, which
+ *  decompresses it and checks that the point is on that curve.
+ *
+ *  @return 0 - success, -1 on a malformed string, checksum mismatch, a curve that is
+ *          not built in or a key that is not a point on its curve.
+ */
+int eos_pubkey_from_string(const char* str, uint8_t pub_key[64]);
+
+/**
+ *  Format a private key as "PVT_K1_..." / "PVT_R1_...".
+ *
+ *  @return 0 - success
+ */
+int eos_privkey_to_string(
+    const uint8_t priv_key[EOS_PRIV_KEY_SIZE],
+    eos_key_type_t type,
+    char* out,
+    uint32_t out_size);
+
+/**
+ *  Format a K1 private key in the legacy WIF form ("5...").
+ *
+ *  @return 0 - success
+ */
+int eos_privkey_to_wif(const uint8_t priv_key[EOS_PRIV_KEY_SIZE], char* out, uint32_t out_size);
+
+/**
+ *  Parse "PVT_K1_...", "PVT_R1_..." or a legacy WIF string.
+ *
+ *  @param(type) [out] key type named by the string; WIF keys are K1.
+ *
+ *  @return 0 - success, -1 on a malformed string or checksum mismatch.
+ */
+int eos_privkey_from_string(
+    const char* str,
+    uint8_t priv_key[EOS_PRIV_KEY_SIZE],
+    eos_key_type_t* type);
+
+/**
+ *  Format a 65-byte compact signature (recovery byte, r, s) as "SIG_K1_...".
+ *
+ *  @return 0 - success
+ */
+int eos_signature_to_string(
+    const uint8_t sig[EOS_SIGNATURE_SIZE],
+    eos_key_type_t type,
+    char* out,
+    uint32_t out_size);
+
+/**
+ *  Parse "SIG_K1_..." / "SIG_R1_..." into a 65-byte compact signature.
+ *
+ *  @return 0 - success, -1 on a malformed string or checksum mismatch.
+ */
+int eos_signature_from_string(
+    const char* str,
+    uint8_t sig[EOS_SIGNATURE_SIZE],
+    eos_key_type_t* type);
+
+#endif // __EOS_KEYS_H
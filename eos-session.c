@@ -0,0 +1,282 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Authenticated sensor session between a device and its gateway.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "eos-session.h"
+#include "ecdsa-engines/sw/uecc.h"
+
+#define SESSION_LABEL       "EOS sensor session v1"
+#define SESSION_LABEL_LEN   (sizeof(SESSION_LABEL) - 1)
+#define EPH_MESSAGE_LEN     (SESSION_LABEL_LEN + 128)
+
+/* Clear key material through a volatile pointer so the stores are kept even
+   though the buffer is not read again. */
+static void wipe(void* buf, unsigned size)
+{
+    volatile uint8_t* p = (volatile uint8_t*)buf;
+    while(size--)
+    {
+        *p++ = 0;
+    }
+}
+
+/* What the device signs to vouch for its ephemeral key:
+   label || ephemeral public key || gateway public key. */
+static void eph_message(
+    uint8_t msg[EPH_MESSAGE_LEN],
+    const uint8_t eph_pub[64],
+    const uint8_t gateway_pub[64])
+{
+    memcpy(msg, SESSION_LABEL, SESSION_LABEL_LEN);
+    memcpy(msg + SESSION_LABEL_LEN, eph_pub, 64);
+    memcpy(msg + SESSION_LABEL_LEN + 64, gateway_pub, 64);
+}
+
+/* Both ends bind the MAC key to the public keys of the exchange:
+   info = label || ephemeral public key || gateway public key ||
+   device public key. */
+static void derive_keys(
+    eos_session_t* session,
+    uint8_t secret[32],
+    const uint8_t eph_pub[64],
+    const uint8_t gateway_pub[64],
+    const uint8_t device_pub[64])
+{
+    uint8_t info[SESSION_LABEL_LEN + 192];
+    uint8_t prk[32];
+    uint8_t mac_key[32];
+
+    memcpy(info, SESSION_LABEL, SESSION_LABEL_LEN);
+    memcpy(info + SESSION_LABEL_LEN, eph_pub, 64);
+    memcpy(info + SESSION_LABEL_LEN + 64, gateway_pub, 64);
+    memcpy(info + SESSION_LABEL_LEN + 128, device_pub, 64);
+
+    hkdf_sha256_extract(NULL, 0, secret, 32, prk);
+    hkdf_sha256_expand(prk, info, sizeof(info), mac_key, sizeof(mac_key));
+    hmac_sha256_key_init(&session->mac_key, mac_key, sizeof(mac_key));
+
+    session->seq = 0;
+    session->checkpoint_seq = 0;
+    session->since_checkpoint = 0;
+    sha256_init(&session->log);
+
+    wipe(secret, 32);
+    wipe(prk, sizeof(prk));
+    wipe(mac_key, sizeof(mac_key));
+}
+
+static void put_seq(uint8_t seq_be[4], uint32_t seq)
+{
+    seq_be[0] = seq >> 24;
+    seq_be[1] = seq >> 16;
+    seq_be[2] = seq >> 8;
+    seq_be[3] = seq;
+}
+
+static void compute_tag(
+    eos_session_t* session,
+    uint32_t seq,
+    const uint8_t* reading,
+    uint32_t len,
+    uint8_t tag[EOS_SESSION_TAG_SIZE])
+{
+    hmac_sha256_ctx_t ctx;
+    uint8_t mac[32];
+    uint8_t seq_be[4];
+
+    put_seq(seq_be, seq);
+
+    hmac_sha256_init(&ctx, &session->mac_key);
+    hmac_sha256_update(&ctx, seq_be, sizeof(seq_be));
+    hmac_sha256_update(&ctx, reading, len);
+    hmac_sha256_final(&ctx, mac);
+    memcpy(tag, mac, EOS_SESSION_TAG_SIZE);
+}
+
+/* The sequence number goes into the log with the tag, so the two ends'
+   logs only agree when they cover the same readings. */
+static void log_tag(
+    eos_session_t* session,
+    uint32_t seq,
+    const uint8_t tag[EOS_SESSION_TAG_SIZE])
+{
+    uint8_t seq_be[4];
+
+    put_seq(seq_be, seq);
+    sha256_update(&session->log, seq_be, sizeof(seq_be));
+    sha256_update(&session->log, tag, EOS_SESSION_TAG_SIZE);
+    session->since_checkpoint++;
+}
+
+int eos_session_start(
+    eos_session_t* session,
+    const uint8_t device_priv[32],
+    const uint8_t gateway_pub[64],
+    uint8_t eph_pub[64],
+    ecdsa_signature_t* eph_sig)
+{
+    uint8_t msg[EPH_MESSAGE_LEN];
+    uint8_t secret[32];
+    uint8_t device_pub[64];
+
+    if(ecdsa_get_pubkey(device_priv, device_pub) != 0)
+    {
+        return -1;
+    }
+    if(!uECC_ecdhe(gateway_pub, eph_pub, secret))
+    {
+        wipe(secret, sizeof(secret));
+        return -1;
+    }
+
+    eph_message(msg, eph_pub, gateway_pub);
+    if(ecdsa_sign(device_priv, msg, sizeof(msg), eph_sig) != 0)
+    {
+        wipe(secret, sizeof(secret));
+        return -1;
+    }
+
+    derive_keys(session, secret, eph_pub, gateway_pub, device_pub);
+    return 0;
+}
+
+int eos_session_accept(
+    eos_session_t* session,
+    const uint8_t gateway_priv[32],
+    const uint8_t device_pub[64],
+    const uint8_t eph_pub[64],
+    const ecdsa_signature_t* eph_sig)
+{
+    uint8_t msg[EPH_MESSAGE_LEN];
+    ecdsa_signature_t sig;
+    uint8_t secret[32];
+    uint8_t gateway_pub[64];
+
+    if(!uECC_get_pubkey(gateway_priv, gateway_pub))
+    {
+        return -1;
+    }
+
+    eph_message(msg, eph_pub, gateway_pub);
+    memcpy(&sig, eph_sig, sizeof(sig));
+    if(ecdsa_verify(device_pub, msg, sizeof(msg), &sig) != 0)
+    {
+        return -1;
+    }
+
+    if(!uECC_shared_secret(eph_pub, gateway_priv, secret))
+    {
+        wipe(secret, sizeof(secret));
+        return -1;
+    }
+
+    derive_keys(session, secret, eph_pub, gateway_pub, device_pub);
+    return 0;
+}
+
+int eos_session_mac(
+    eos_session_t* session,
+    const uint8_t* reading,
+    uint32_t len,
+    uint32_t* seq,
+    uint8_t tag[EOS_SESSION_TAG_SIZE])
+{
+    if(session->seq == 0xFFFFFFFF)
+    {
+        return -1;
+    }
+
+    compute_tag(session, session->seq, reading, len, tag);
+    log_tag(session, session->seq, tag);
+    *seq = session->seq++;
+    return 0;
+}
+
+int eos_session_check(
+    eos_session_t* session,
+    uint32_t seq,
+    const uint8_t* reading,
+    uint32_t len,
+    const uint8_t tag[EOS_SESSION_TAG_SIZE])
+{
+    uint8_t expected[EOS_SESSION_TAG_SIZE];
+    uint8_t diff = 0;
+    int i;
+
+    if(seq < session->seq || seq == 0xFFFFFFFF)
+    {
+        return -1;
+    }
+
+    compute_tag(session, seq, reading, len, expected);
+
+    /* Compare in constant time. */
+    for(i = 0; i < EOS_SESSION_TAG_SIZE; ++i)
+    {
+        diff |= expected[i] ^ tag[i];
+    }
+    if(diff)
+    {
+        return -1;
+    }
+
+    log_tag(session, seq, tag);
+    session->seq = seq + 1;
+    return 0;
+}
+
+int eos_session_checkpoint_due(const eos_session_t* session)
+{
+    return session->since_checkpoint >= EOS_SESSION_CHECKPOINT_INTERVAL;
+}
+
+void eos_session_checkpoint(
+    eos_session_t* session,
+    eos_session_checkpoint_t* checkpoint)
+{
+    checkpoint->first_seq = session->checkpoint_seq;
+    checkpoint->next_seq = session->seq;
+    checkpoint->count = session->since_checkpoint;
+    sha256_final(&session->log, checkpoint->log_hash);
+
+    sha256_init(&session->log);
+    session->checkpoint_seq = session->seq;
+    session->since_checkpoint = 0;
+}
+
+void eos_session_end(eos_session_t* session)
+{
+    wipe(session, sizeof(*session));
+}
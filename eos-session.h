@@ -0,0 +1,174 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    Authenticated sensor session between a device and its gateway.
+*
+*    The two ends run a single ephemeral-static ECDH, derive a MAC key with
+*    HKDF-SHA256 and then tag each reading with a truncated HMAC-SHA256
+*    instead of an ECDSA signature. The device signs its ephemeral key with
+*    its static key, so the gateway knows whom the session belongs to. The
+*    sequence numbers and tags are chained into a log hash which the device
+*    commits to on-chain in a periodic checkpoint transaction; only that
+*    transaction and the ephemeral key are signed with ECDSA.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __EOS_SESSION_H
+#define __EOS_SESSION_H
+
+#include <stdint.h>
+#include "ecdsa-engines/sw/sha256.h"
+#include "ecdsa-engines/sw/hmac-sha256.h"
+#include "ecdsa-engine.h"
+
+/* EOS_SESSION_TAG_SIZE - Bytes of HMAC-SHA256 kept per reading, at most 32.
+   Override with EOS_SESSION_CONF_TAG_SIZE. */
+#ifdef EOS_SESSION_CONF_TAG_SIZE
+#define EOS_SESSION_TAG_SIZE EOS_SESSION_CONF_TAG_SIZE
+#else
+#define EOS_SESSION_TAG_SIZE 16
+#endif
+
+/* EOS_SESSION_CHECKPOINT_INTERVAL - Number of readings after which
+   eos_session_checkpoint_due() asks for a signed checkpoint transaction.
+   Override with EOS_SESSION_CONF_CHECKPOINT_INTERVAL. */
+#ifdef EOS_SESSION_CONF_CHECKPOINT_INTERVAL
+#define EOS_SESSION_CHECKPOINT_INTERVAL EOS_SESSION_CONF_CHECKPOINT_INTERVAL
+#else
+#define EOS_SESSION_CHECKPOINT_INTERVAL 256
+#endif
+
+typedef struct
+{
+    hmac_sha256_key_t mac_key;
+    uint32_t seq;               /* sequence number of the next reading */
+    uint32_t checkpoint_seq;    /* first sequence number since the last checkpoint */
+    uint32_t since_checkpoint;  /* readings logged since the last checkpoint */
+    sha256_ctx_t log;           /* running hash of their sequence numbers and tags */
+} eos_session_t;
+
+/**
+ *  One checkpoint period. The device logs every reading it tags, so its
+ *  count is always next_seq - first_seq. The gateway logs the readings that
+ *  arrived; a lower count means readings were lost, and the sequence
+ *  numbers it did check tell which ones. The log hashes only match when
+ *  the gateway has every reading of the period.
+ */
+typedef struct
+{
+    uint32_t first_seq;         /* first sequence number of the period */
+    uint32_t next_seq;          /* one past the last sequence number logged */
+    uint32_t count;             /* readings logged */
+    uint8_t log_hash[32];       /* hash of seq || tag of each, in order */
+} eos_session_checkpoint_t;
+
+/**
+ *  Device side: open a session with the gateway's static public key.
+ *
+ *  @param(device_priv) [in] device's static key, signs the ephemeral key.
+ *  @param(eph_pub) [out] ephemeral public key to send to the gateway.
+ *  @param(eph_sig) [out] signature over the ephemeral key, sent along with it.
+ *
+ *  @return 0 - success, -1 if the gateway key is invalid or no key could be made.
+ */
+int eos_session_start(
+    eos_session_t* session,
+    const uint8_t device_priv[32],
+    const uint8_t gateway_pub[64],
+    uint8_t eph_pub[64],
+    ecdsa_signature_t* eph_sig);
+
+/**
+ *  Gateway side: open the matching session from the device's ephemeral key,
+ *  after checking that the device signed it. The gateway should also refuse
+ *  an ephemeral key it has accepted before, or the readings of that earlier
+ *  session could be replayed into this one.
+ *
+ *  @param(device_pub) [in] device's static public key.
+ *
+ *  @return 0 - success, -1 if the ephemeral key is invalid or not signed by the device.
+ */
+int eos_session_accept(
+    eos_session_t* session,
+    const uint8_t gateway_priv[32],
+    const uint8_t device_pub[64],
+    const uint8_t eph_pub[64],
+    const ecdsa_signature_t* eph_sig);
+
+/**
+ *  Device side: tag the next reading. The tag covers the sequence number
+ *  and the reading, and is added to the checkpoint log.
+ *
+ *  @param(seq) [out] sequence number to send along with the reading.
+ *
+ *  @return 0 - success, -1 if the sequence space is used up and the session must be renewed.
+ */
+int eos_session_mac(
+    eos_session_t* session,
+    const uint8_t* reading,
+    uint32_t len,
+    uint32_t* seq,
+    uint8_t tag[EOS_SESSION_TAG_SIZE]);
+
+/**
+ *  Gateway side: check a received reading. Replayed or out-of-order
+ *  sequence numbers are rejected; gaps left by lost readings are accepted
+ *  and show up in the next checkpoint.
+ *
+ *  @return 0 - the reading is authentic, -1 otherwise.
+ */
+int eos_session_check(
+    eos_session_t* session,
+    uint32_t seq,
+    const uint8_t* reading,
+    uint32_t len,
+    const uint8_t tag[EOS_SESSION_TAG_SIZE]);
+
+/**
+ *  Whether enough readings have been tagged to warrant a checkpoint.
+ */
+int eos_session_checkpoint_due(const eos_session_t* session);
+
+/**
+ *  Close the current checkpoint period. The device puts the checkpoint in
+ *  the checkpoint transaction, which is then signed with ecdsa_sign_trx().
+ *  The gateway closes its period on receiving the device's, and compares
+ *  the two.
+ */
+void eos_session_checkpoint(
+    eos_session_t* session,
+    eos_session_checkpoint_t* checkpoint);
+
+/**
+ *  Wipe the session keys.
+ */
+void eos_session_end(eos_session_t* session);
+
+#endif
@@ -40,10 +40,27 @@
 
 #include "ecdsa-engines/hw/ecdsa-cc26x2-adapter.h"
 #include "ecdsa-engines/sw/ecdsa-uecc-adapter.h"
+#include "ecdsa-engines/ecdsa-engine-impl.h"
+#include "ecdsa-engine.h"
+#include "ecdsa-pt.h"
+#include "ecdsa-service.h"
+#include "ecdsa-signature.h"
+#include "ecdsa-stack.h"
+#include "eos-keys.h"
 
 
 void test_ecdsa();
 void test_cc26x2_nistp256();
+static void print_sig(uint8_t r[32], uint8_t s[32]);
+static void test_signature_encoding(const uint8_t r[32], const uint8_t s[32]);
+static int test_pipeline_begin(ecdsa_pipeline_t* pipeline);
+static void test_pipeline_check(const ecdsa_pipeline_t* pipeline);
+static int test_service_submit();
+static int test_service_signed(const ecdsa_job_t* job);
+static void test_service_verified(const ecdsa_job_t* job);
+static void test_verify_cache();
+static void test_verify_cache_expiry();
+static uint8_t k[32];
 
 /*---------------------------------------------------------------------------*/
 PROCESS(eos_process, "eos process");
@@ -52,12 +69,59 @@ AUTOSTART_PROCESSES(&eos_process);
 PROCESS_THREAD(eos_process, ev, data)
 {
   static struct etimer timer;
+  static struct pt step_pt;
+  static ecdsa_sign_ctx_t sign_ctx;
+  static ecdsa_verify_ctx_t verify_ctx;
+  static ecdsa_signature_t sig;
+  static uint8_t hash[32];
+  static uint8_t pub_key[64];
+  static ecdsa_pipeline_t pipeline;
 
   PROCESS_BEGIN();
 
   test_ecdsa();
   //test_cc26x2_nistp256();
 
+  /* Sign and verify without holding up the event loop. The test nonce
+     doubles as the private key. */
+  printf("----- Resumable sign and verify\n");
+  ecdsa_pt_init();
+  sha256((const uint8_t*)"Hello, EOS", 10, hash);
+  ecdsa_get_pubkey(k, pub_key);
+  if(ecdsa_sign_begin(&sign_ctx, k, hash) == 0) {
+    PROCESS_PT_SPAWN(&step_pt, ecdsa_sign_pt(&step_pt, &sign_ctx, PROCESS_CURRENT()));
+    PROCESS_WAIT_EVENT_UNTIL(ev == ecdsa_event_done);
+  }
+  if(ecdsa_sign_result(&sign_ctx, &sig) == 0) {
+    print_sig(sig.r, sig.s);
+    ecdsa_verify_begin(&verify_ctx, pub_key, hash, &sig);
+    PROCESS_PT_SPAWN(&step_pt, ecdsa_verify_pt(&step_pt, &verify_ctx, PROCESS_CURRENT()));
+    PROCESS_WAIT_EVENT_UNTIL(ev == ecdsa_event_done);
+    printf("Resumable verify %s\n", ecdsa_verify_result(&verify_ctx) == 0 ? "SUCCESS!" : "FAILED!");
+  } else {
+    printf("Resumable sign FAILED!\n");
+  }
+
+  if(test_pipeline_begin(&pipeline) == 0) {
+    PROCESS_PT_SPAWN(&step_pt, ecdsa_pipeline_pt(&step_pt, &pipeline, PROCESS_CURRENT()));
+    PROCESS_WAIT_EVENT_UNTIL(ev == ecdsa_event_done);
+  }
+  test_pipeline_check(&pipeline);
+
+  if(test_service_submit() == 0) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == ecdsa_event_done);
+    if(test_service_signed((const ecdsa_job_t*)data) == 0) {
+      PROCESS_WAIT_EVENT_UNTIL(ev == ecdsa_event_done);
+      test_service_verified((const ecdsa_job_t*)data);
+    }
+  }
+
+  test_verify_cache();
+  printf("Waiting %d s for the cached verification to expire...\n", ECDSA_VERIFY_CACHE_TTL + 1);
+  etimer_set(&timer, CLOCK_SECOND * (ECDSA_VERIFY_CACHE_TTL + 1));
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&timer));
+  test_verify_cache_expiry();
+
   etimer_set(&timer, CLOCK_SECOND * 5);
 
   while(1) {
@@ -171,14 +235,55 @@ void test_cc26x2_nistp256()
 void test_ecdsa()
 {
     uint8_t pub_key[64];
+    uint8_t derived_key[64];
     uint8_t priv_key[32];
     uint8_t hash[32];
     uint8_t r[32];
     uint8_t s[32];
+    char key_str[EOS_PUB_KEY_STR_SIZE];
 
     ecdsa_uecc_init(fake_rng);
     ecdsa_cc26x2_init(ECDSA_CC26X2_CURVE_SECP256K1);
 
+    printf("----- Engine backend selection\n");
+    ecdsa_init();
+    printf("get pubkey: %s (%lu ticks)\n",
+        ecdsa_engine_selected(ECDSA_OP_GET_PUBKEY) ? ecdsa_engine_selected(ECDSA_OP_GET_PUBKEY)->name : "none",
+        (unsigned long)ecdsa_engine_ticks(ECDSA_OP_GET_PUBKEY));
+    printf("sign: %s (%lu ticks)\n",
+        ecdsa_engine_selected(ECDSA_OP_SIGN) ? ecdsa_engine_selected(ECDSA_OP_SIGN)->name : "none",
+        (unsigned long)ecdsa_engine_ticks(ECDSA_OP_SIGN));
+    printf("verify: %s (%lu ticks)\n",
+        ecdsa_engine_selected(ECDSA_OP_VERIFY) ? ecdsa_engine_selected(ECDSA_OP_VERIFY)->name : "none",
+        (unsigned long)ecdsa_engine_ticks(ECDSA_OP_VERIFY));
+
+#if ECDSA_STACK_PROFILE
+    printf("----- Stack use (bytes)\n");
+    {
+        const ecdsa_engine_backend_t* backends[] = {
+            &ecdsa_uecc_backend,
+#if ECDSA_ENGINE_WITH_CC26X2
+            &ecdsa_cc26x2_backend,
+#endif
+        };
+        ecdsa_stack_usage_t usage;
+        unsigned i;
+
+        for(i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+        {
+            if(ecdsa_stack_measure(backends[i], &usage) != 0)
+            {
+                printf("%s: FAILED\n", backends[i]->name);
+                continue;
+            }
+            printf("%s: keygen=%lu sign=%lu verify=%lu hash=%lu\n", backends[i]->name,
+                (unsigned long)usage.keygen, (unsigned long)usage.sign,
+                (unsigned long)usage.verify, (unsigned long)usage.hash);
+            watchdog_periodic();
+        }
+    }
+
+#endif
     printf("----- UECC internal test\n");
     ecdsa_uecc_test();
 
@@ -189,6 +294,20 @@ void test_ecdsa()
     print_hex(pub_key, sizeof(pub_key));
     printf("private: 0x");
     print_hex(priv_key, sizeof(priv_key));
+    if (eos_pubkey_to_string(pub_key, key_str, sizeof(key_str)) == 0) {
+        printf("public: %s\n", key_str);
+    }
+    if (eos_privkey_to_string(priv_key, EOS_KEY_K1, key_str, sizeof(key_str)) == 0) {
+        printf("private: %s\n", key_str);
+    }
+    printf("UECC get pubkey...\n");
+    if (ecdsa_uecc_get_pubkey(priv_key, derived_key) == 0 &&
+        memcmp(derived_key, pub_key, sizeof(pub_key)) == 0) {
+        printf("UECC get pubkey SUCCESS!\n");
+    } else {
+        printf("UECC get pubkey FAILED!\n");
+    }
+    watchdog_periodic();
     /* use portion of generated pub key as message hash */
     memcpy(hash, pub_key, sizeof(hash));
     printf("hash: 0x");
@@ -280,4 +399,274 @@ void test_ecdsa()
     }
     watchdog_periodic();
 
-}
\ No newline at end of file
+    test_signature_encoding(r, s);
+}
+
+static void test_signature_encoding(const uint8_t r[32], const uint8_t s[32])
+{
+    /* secp256k1 n - 1, the highest possible s */
+    static const uint8_t n_minus_1[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+        0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B,
+        0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x40 };
+    /* SEQUENCE { INTEGER 1, INTEGER 1 }, minimal and with r padded by a zero */
+    static const uint8_t der_minimal[] = { 0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01 };
+    static const uint8_t der_padded[] = { 0x30, 0x07, 0x02, 0x02, 0x00, 0x01, 0x02, 0x01, 0x01 };
+    ecdsa_signature_t sig;
+    ecdsa_signature_t parsed;
+    ecdsa_der_view_t view;
+    uint8_t der[ECDSA_SIG_DER_MAX_SIZE];
+    int len;
+
+    printf("----- Signature encoding test\n");
+
+    /* The last signature, low-S normalized, must survive a DER round trip. */
+    memcpy(sig.r, r, 32);
+    memcpy(sig.s, s, 32);
+    ecdsa_sig_normalize_s(&sig, ECDSA_CURVE_SECP256K1);
+    len = ecdsa_sig_to_der(&sig, der, sizeof(der));
+    if (len > 0 &&
+        ecdsa_sig_from_der(der, (uint32_t)len, ECDSA_CURVE_SECP256K1, &parsed) == 0 &&
+        memcmp(&parsed, &sig, sizeof(sig)) == 0) {
+        printf("DER round trip SUCCESS!\n");
+    }
+    else {
+        printf("DER round trip FAILED!\n");
+    }
+
+    /* s = n - 1 is high: rejected as is, accepted once normalized to 1. */
+    memset(sig.r, 0, 32);
+    sig.r[31] = 1;
+    memcpy(sig.s, n_minus_1, 32);
+    len = ecdsa_sig_to_der(&sig, der, sizeof(der));
+    if (len > 0 &&
+        ecdsa_sig_from_der(der, (uint32_t)len, ECDSA_CURVE_SECP256K1, &parsed) != 0 &&
+        ecdsa_sig_normalize_s(&sig, ECDSA_CURVE_SECP256K1) == 1 &&
+        (len = ecdsa_sig_to_der(&sig, der, sizeof(der))) > 0 &&
+        ecdsa_sig_from_der(der, (uint32_t)len, ECDSA_CURVE_SECP256K1, &parsed) == 0 &&
+        parsed.s[31] == 1) {
+        printf("DER high-S rejection SUCCESS!\n");
+    }
+    else {
+        printf("DER high-S rejection FAILED!\n");
+    }
+
+    /* An INTEGER with a superfluous leading zero is not DER. */
+    if (ecdsa_sig_der_parse(der_minimal, sizeof(der_minimal), &view) == 0 &&
+        ecdsa_sig_der_parse(der_padded, sizeof(der_padded), &view) != 0) {
+        printf("DER non-minimal INTEGER rejection SUCCESS!\n");
+    }
+    else {
+        printf("DER non-minimal INTEGER rejection FAILED!\n");
+    }
+}
+
+#define PIPELINE_TEST_ITEMS 3
+
+static ecdsa_signature_t pipeline_sigs[PIPELINE_TEST_ITEMS];
+static uint32_t pipeline_delivered;
+static int pipeline_in_order;
+
+/* Item i of the stream is the message "Pipeline item <i>". */
+static void pipeline_message(uint32_t index, char message[16])
+{
+    memcpy(message, "Pipeline item ", 14);
+    message[14] = (char)('0' + index);
+    message[15] = '\0';
+}
+
+static int pipeline_hash(void* arg, uint32_t index, uint8_t hash[32])
+{
+    char message[16];
+
+    pipeline_message(index, message);
+    sha256((const uint8_t*)message, 15, hash);
+    return 0;
+}
+
+static void pipeline_done(void* arg, uint32_t index, int status, const ecdsa_signature_t* sig)
+{
+    if (index != pipeline_delivered || status != 0) {
+        pipeline_in_order = 0;
+    }
+    else {
+        pipeline_sigs[index] = *sig;
+    }
+    pipeline_delivered++;
+}
+
+static int test_pipeline_begin(ecdsa_pipeline_t* pipeline)
+{
+    printf("----- Pipeline signing test\n");
+    pipeline_delivered = 0;
+    pipeline_in_order = 1;
+    if (ecdsa_pipeline_begin(pipeline, k, PIPELINE_TEST_ITEMS, pipeline_hash, pipeline_done, NULL) != 0) {
+        printf("Pipeline begin FAILED!\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* Every item must be delivered once, in order, with a valid signature. */
+static void test_pipeline_check(const ecdsa_pipeline_t* pipeline)
+{
+    uint8_t pub_key[64];
+    char message[16];
+    uint32_t i;
+    int result;
+
+    result = (pipeline->result == 0 && pipeline_in_order &&
+              pipeline_delivered == PIPELINE_TEST_ITEMS &&
+              ecdsa_get_pubkey(k, pub_key) == 0) ? 0 : -1;
+    for (i = 0; result == 0 && i < PIPELINE_TEST_ITEMS; i++) {
+        pipeline_message(i, message);
+        result = ecdsa_verify(pub_key, (const uint8_t*)message, 15, &pipeline_sigs[i]);
+        watchdog_periodic();
+    }
+    if (result == 0) {
+        printf("Pipeline sign SUCCESS!\n");
+    }
+    else {
+        printf("Pipeline sign FAILED!\n");
+    }
+}
+
+static ecdsa_job_t service_sign_job;
+static ecdsa_job_t service_cancel_job;
+static ecdsa_job_t service_verify_job;
+static ecdsa_signature_t service_sig;
+static ecdsa_signature_t service_cancel_sig;
+static uint8_t service_hash[32];
+static uint8_t service_pub_key[64];
+static int service_cancelled;
+
+/* Queue two signatures and withdraw the second before the service runs. */
+static int test_service_submit()
+{
+    printf("----- Service test\n");
+    ecdsa_service_init();
+    sha256((const uint8_t*)"Service job", 11, service_hash);
+    memset(&service_sign_job, 0, sizeof(service_sign_job));
+    memset(&service_cancel_job, 0, sizeof(service_cancel_job));
+    memset(&service_verify_job, 0, sizeof(service_verify_job));
+
+    if (ecdsa_get_pubkey(k, service_pub_key) != 0 ||
+        ecdsa_service_sign(&service_sign_job, 0, k, service_hash, &service_sig) != 0 ||
+        ecdsa_service_sign(&service_cancel_job, 0, k, service_hash, &service_cancel_sig) != 0) {
+        printf("Service submit FAILED!\n");
+        return -1;
+    }
+
+    /* Cancelling is only possible once. */
+    service_cancelled = ecdsa_service_cancel(&service_cancel_job) == 0 &&
+                        service_cancel_job.state == ECDSA_JOB_CANCELLED &&
+                        ecdsa_service_cancel(&service_cancel_job) != 0;
+    return 0;
+}
+
+/* The first completion must be the signing job; queue a check of its result. */
+static int test_service_signed(const ecdsa_job_t* job)
+{
+    if (job != &service_sign_job || job->result != 0 ||
+        ecdsa_service_verify(&service_verify_job, 0, service_pub_key, service_hash, &service_sig) != 0) {
+        printf("Service sign FAILED!\n");
+        return -1;
+    }
+    printf("Service sign SUCCESS!\n");
+    return 0;
+}
+
+/* Had the cancelled job run, its event would have come before this one. */
+static void test_service_verified(const ecdsa_job_t* job)
+{
+    if (job == &service_verify_job && job->result == 0) {
+        printf("Service verify SUCCESS!\n");
+    }
+    else {
+        printf("Service verify FAILED!\n");
+    }
+    if (service_cancelled && job != &service_cancel_job &&
+        service_cancel_job.state == ECDSA_JOB_CANCELLED) {
+        printf("Service cancel SUCCESS!\n");
+    }
+    else {
+        printf("Service cancel FAILED!\n");
+    }
+}
+
+static const char cache_message[] = "Verify me once";
+static ecdsa_signature_t cache_sig;
+static uint32_t cache_misses;
+
+static void test_verify_cache()
+{
+    uint8_t pub_key[64];
+    ecdsa_signature_t sig;
+    uint32_t hits;
+    uint32_t misses;
+    int first;
+    int second;
+
+    printf("----- Verification cache test\n");
+    ecdsa_verify_cache_clear();
+    if (ecdsa_get_pubkey(k, pub_key) != 0 ||
+        ecdsa_sign(k, (const uint8_t*)cache_message, sizeof(cache_message) - 1, &cache_sig) != 0) {
+        printf("Verify cache sign FAILED!\n");
+        return;
+    }
+    watchdog_periodic();
+
+    /* The first verification misses and is remembered; the repeat hits. */
+    sig = cache_sig;
+    first = ecdsa_verify(pub_key, (const uint8_t*)cache_message, sizeof(cache_message) - 1, &sig);
+    watchdog_periodic();
+    sig = cache_sig;
+    second = ecdsa_verify(pub_key, (const uint8_t*)cache_message, sizeof(cache_message) - 1, &sig);
+    ecdsa_verify_cache_stats(&hits, &misses);
+    if (first == 0 && second == 0 && hits == 1 && misses == 1) {
+        printf("Verify cache hit SUCCESS!\n");
+    }
+    else {
+        printf("Verify cache hit FAILED!\n");
+    }
+
+    /* A tampered signature must not match the cached one. */
+    sig = cache_sig;
+    sig.s[31] ^= 0x01;
+    first = ecdsa_verify(pub_key, (const uint8_t*)cache_message, sizeof(cache_message) - 1, &sig);
+    watchdog_periodic();
+    ecdsa_verify_cache_stats(&hits, &misses);
+    if (first != 0 && hits == 1 && misses == 2) {
+        printf("Verify cache tamper miss SUCCESS!\n");
+    }
+    else {
+        printf("Verify cache tamper miss FAILED!\n");
+    }
+    cache_misses = misses;
+}
+
+/* Run more than ECDSA_VERIFY_CACHE_TTL seconds after test_verify_cache(). */
+static void test_verify_cache_expiry()
+{
+    uint8_t pub_key[64];
+    ecdsa_signature_t sig;
+    uint32_t hits;
+    uint32_t misses;
+    int result;
+
+    printf("----- Verification cache expiry test\n");
+    sig = cache_sig;
+    result = -1;
+    if (ecdsa_get_pubkey(k, pub_key) == 0) {
+        result = ecdsa_verify(pub_key, (const uint8_t*)cache_message, sizeof(cache_message) - 1, &sig);
+    }
+    watchdog_periodic();
+    ecdsa_verify_cache_stats(&hits, &misses);
+    if (result == 0 && hits == 1 && misses == cache_misses + 1) {
+        printf("Verify cache expiry SUCCESS!\n");
+    }
+    else {
+        printf("Verify cache expiry FAILED!\n");
+    }
+}
@@ -0,0 +1,201 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    High-resolution timing for benchmarks.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#include "perf-cycles.h"
+
+#if PERF_CYCLES_SOURCE == PERF_CYCLES_RDTSC || PERF_CYCLES_SOURCE == PERF_CYCLES_CLOCK
+#include <time.h>
+#endif
+#if PERF_CYCLES_SOURCE == PERF_CYCLES_RTIMER
+#include "contiki.h"
+#include "sys/rtimer.h"
+#endif
+
+#if PERF_CYCLES_SOURCE == PERF_CYCLES_DWT
+
+#define DEMCR           (*(volatile uint32_t*)0xE000EDFC)
+#define DEMCR_TRCENA    (1UL << 24)
+#define DWT_CTRL        (*(volatile uint32_t*)0xE0001000)
+#define DWT_CTRL_CYCCNTENA (1UL << 0)
+#define DWT_CYCCNT      (*(volatile uint32_t*)0xE0001004)
+
+/* Accumulated count and the hardware value it was last brought up to date with. */
+static uint64_t g_total;
+static uint32_t g_last;
+
+void perf_init()
+{
+    if(!(DWT_CTRL & DWT_CTRL_CYCCNTENA))
+    {
+        DEMCR |= DEMCR_TRCENA;
+        DWT_CYCCNT = 0;
+        DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+        g_last = 0;
+    }
+}
+
+uint64_t perf_cycles()
+{
+    uint32_t now = DWT_CYCCNT;
+
+    g_total += (uint32_t)(now - g_last);
+    g_last = now;
+    return g_total;
+}
+
+uint64_t perf_hz()
+{
+    return PERF_CYCLES_CPU_HZ;
+}
+
+const char* perf_source_name()
+{
+    return "dwt";
+}
+
+#elif PERF_CYCLES_SOURCE == PERF_CYCLES_RDTSC
+
+static uint64_t g_hz;
+
+static uint64_t monotonic_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t perf_cycles()
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* The TSC runs at a fixed rate on current parts; measure it against the
+   monotonic clock over 20 ms. */
+void perf_init()
+{
+    uint64_t t0;
+    uint64_t c0;
+    uint64_t t1;
+
+    if(g_hz)
+    {
+        return;
+    }
+
+    t0 = monotonic_ns();
+    c0 = perf_cycles();
+    do
+    {
+        t1 = monotonic_ns();
+    } while(t1 - t0 < 20000000);
+    g_hz = (perf_cycles() - c0) * 1000000000ull / (t1 - t0);
+}
+
+uint64_t perf_hz()
+{
+    perf_init();
+    return g_hz;
+}
+
+const char* perf_source_name()
+{
+    return "rdtsc";
+}
+
+#elif PERF_CYCLES_SOURCE == PERF_CYCLES_CLOCK
+
+void perf_init()
+{
+}
+
+uint64_t perf_cycles()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t perf_hz()
+{
+    return 1000000000ull;
+}
+
+const char* perf_source_name()
+{
+    return "clock_gettime";
+}
+
+#else /* PERF_CYCLES_RTIMER */
+
+static uint64_t g_total;
+static rtimer_clock_t g_last;
+
+void perf_init()
+{
+}
+
+uint64_t perf_cycles()
+{
+    rtimer_clock_t now = RTIMER_NOW();
+
+    g_total += (rtimer_clock_t)(now - g_last);
+    g_last = now;
+    return g_total;
+}
+
+uint64_t perf_hz()
+{
+    return RTIMER_SECOND;
+}
+
+const char* perf_source_name()
+{
+    return "rtimer";
+}
+
+#endif /* PERF_CYCLES_SOURCE */
+
+uint64_t perf_cycles_to_ns(uint64_t cycles)
+{
+    uint64_t hz = perf_hz();
+
+    /* Split to keep the multiplication from overflowing for long intervals. */
+    return (cycles / hz) * 1000000000ull + (cycles % hz) * 1000000000ull / hz;
+}
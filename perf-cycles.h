@@ -0,0 +1,98 @@
+/*
+* Copyright(c) 2018, Firmware Modules Inc.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met :
+*
+* *Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+* \file
+*    High-resolution timing for benchmarks. Uses the Cortex-M DWT cycle
+*    counter on the MCU, the TSC or clock_gettime() on the native Linux
+*    target and rtimer ticks elsewhere.
+*
+* \author
+*    Evan Ross <contact@firmwaremodules.com>
+*/
+
+#ifndef __PERF_CYCLES_H
+#define __PERF_CYCLES_H
+
+#include <stdint.h>
+
+/* Counter sources. */
+#define PERF_CYCLES_DWT     1   /* Cortex-M3/M4/M33 DWT CYCCNT, CPU clock cycles */
+#define PERF_CYCLES_RDTSC   2   /* x86 time stamp counter */
+#define PERF_CYCLES_CLOCK   3   /* clock_gettime(CLOCK_MONOTONIC), nanoseconds */
+#define PERF_CYCLES_RTIMER  4   /* RTIMER_NOW() ticks */
+
+/* PERF_CYCLES_SOURCE - Counter used by perf_cycles(), chosen from the
+   target unless overridden with PERF_CYCLES_CONF_SOURCE. */
+#ifdef PERF_CYCLES_CONF_SOURCE
+#define PERF_CYCLES_SOURCE PERF_CYCLES_CONF_SOURCE
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define PERF_CYCLES_SOURCE PERF_CYCLES_DWT
+#elif defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+#define PERF_CYCLES_SOURCE PERF_CYCLES_RDTSC
+#elif defined(__linux__)
+#define PERF_CYCLES_SOURCE PERF_CYCLES_CLOCK
+#else
+#define PERF_CYCLES_SOURCE PERF_CYCLES_RTIMER
+#endif
+
+/* PERF_CYCLES_CPU_HZ - CPU clock, used to convert DWT cycles to time.
+   Override with PERF_CYCLES_CONF_CPU_HZ. */
+#ifdef PERF_CYCLES_CONF_CPU_HZ
+#define PERF_CYCLES_CPU_HZ PERF_CYCLES_CONF_CPU_HZ
+#else
+#define PERF_CYCLES_CPU_HZ 48000000
+#endif
+
+/**
+ *  Start the counter: enables the DWT cycle counter or measures the TSC
+ *  rate. Safe to call more than once.
+ */
+void perf_init();
+
+/**
+ *  Counter value, extended to 64 bits. The hardware counter on the MCU is
+ *  32 bits wide, so it must be read at least once per wrap (about 89 s at
+ *  48 MHz) for the extension to hold.
+ */
+uint64_t perf_cycles();
+
+/**
+ *  Counter rate in counts per second.
+ */
+uint64_t perf_hz();
+
+/**
+ *  Convert a count difference to nanoseconds.
+ */
+uint64_t perf_cycles_to_ns(uint64_t cycles);
+
+/**
+ *  Name of the counter source, for benchmark output.
+ */
+const char* perf_source_name();
+
+#endif // __PERF_CYCLES_H